@@ -22,6 +22,11 @@ for /d %%i in (%root%\*) do (
     for %%j in (!subdir!\*.frag) do (
         glslc.exe %%j -o !subdir!\%%~nj.frag.spv
     )
+
+    :: Compile .comp files
+    for %%j in (!subdir!\*.comp) do (
+        glslc.exe %%j -o !subdir!\%%~nj.comp.spv
+    )
 )
 
 ::echo Compilation completed successfully.
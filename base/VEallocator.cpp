@@ -0,0 +1,415 @@
+#include "VEallocator.h"
+
+#include <bit>
+#include <algorithm>
+#include <iomanip>
+
+static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+	return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+// ------------- Memory Block (TLSF) ----------------
+
+VEmemoryBlock::VEmemoryBlock(vk::DeviceMemory memory, vk::DeviceSize size, uint32_t memoryType, void* mapped)
+	: memory(memory), size(size), memoryType(memoryType), mapped(mapped) {
+	for (auto& list : freeLists) {
+		std::fill(std::begin(list), std::end(list), INVALID);
+	}
+
+	// 처음에는 block 전체가 하나의 free region (항상 index 0이 offset 0 region)
+	uint32_t index = newRegion();
+	regions[index] = Region{
+		.offset = 0,
+		.size = size,
+		.isFree = true,
+		.prevPhysical = INVALID,
+		.nextPhysical = INVALID,
+	};
+	insertFree(index);
+}
+
+void VEmemoryBlock::mapping(vk::DeviceSize size, uint32_t& fl, uint32_t& sl) {
+	if (size < SMALL_SIZE) {
+		fl = 0;
+		sl = static_cast<uint32_t>(size / (SMALL_SIZE / SL_COUNT));
+	}
+	else {
+		uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		sl = static_cast<uint32_t>(size >> (msb - SL_LOG2)) ^ SL_COUNT;
+		fl = msb - FL_SHIFT + 1;
+	}
+}
+
+// size 이상임이 보장되는 가장 작은 size class에서 free region을 찾는다
+uint32_t VEmemoryBlock::findFree(vk::DeviceSize size) const {
+	if (size < SMALL_SIZE) {
+		size = alignUp(size, SMALL_SIZE / SL_COUNT);
+	}
+	else {
+		uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		size += (vk::DeviceSize(1) << (msb - SL_LOG2)) - 1;
+	}
+
+	uint32_t fl, sl;
+	mapping(size, fl, sl);
+	if (fl >= FL_COUNT) {
+		return INVALID;
+	}
+
+	uint32_t slMap = slBitmap[fl] & (~0u << sl);
+	if (!slMap) {
+		uint64_t flMap = fl + 1 < 64 ? flBitmap & (~0ull << (fl + 1)) : 0;
+		if (!flMap) {
+			return INVALID;
+		}
+
+		fl = static_cast<uint32_t>(std::countr_zero(flMap));
+		slMap = slBitmap[fl];
+	}
+	sl = static_cast<uint32_t>(std::countr_zero(slMap));
+
+	return freeLists[fl][sl];
+}
+
+bool VEmemoryBlock::allocate(vk::DeviceSize requestSize, vk::DeviceSize alignment, VEallocation& allocation) {
+	// region의 offset, size는 항상 MIN_REGION의 배수로 유지한다
+	vk::DeviceSize regionSize = std::max(alignUp(requestSize, MIN_REGION), MIN_REGION);
+	vk::DeviceSize searchSize = regionSize + (alignment > MIN_REGION ? alignment - MIN_REGION : 0);
+
+	uint32_t index = findFree(searchSize);
+	if (index == INVALID) {
+		return false;
+	}
+
+	removeFree(index);
+
+	// 정렬을 위해 앞에 남는 영역은 다시 free region으로 돌려놓는다
+	vk::DeviceSize alignedOffset = alignUp(regions[index].offset, alignment);
+	vk::DeviceSize padding = alignedOffset - regions[index].offset;
+	if (padding > 0) {
+		uint32_t back = split(index, padding);
+		insertFree(index);
+		index = back;
+	}
+
+	if (regions[index].size - regionSize >= MIN_REGION) {
+		uint32_t rest = split(index, regionSize);
+		insertFree(rest);
+	}
+
+	regions[index].isFree = false;
+	allocationCount++;
+	usedBytes += regions[index].size;
+
+	allocation.memory = memory;
+	allocation.offset = regions[index].offset;
+	allocation.size = requestSize;
+	allocation.mapped = mapped ? static_cast<char*>(mapped) + allocation.offset : nullptr;
+	allocation.memoryType = memoryType;
+	allocation.block = this;
+	allocation.region = index;
+
+	return true;
+}
+
+void VEmemoryBlock::free(uint32_t index) {
+	regions[index].isFree = true;
+	allocationCount--;
+	usedBytes -= regions[index].size;
+
+	// 인접한 free region과 합친다 (인접한 두 region이 모두 free인 경우는 없다)
+	uint32_t next = regions[index].nextPhysical;
+	if (next != INVALID && regions[next].isFree) {
+		removeFree(next);
+		merge(index, next);
+	}
+
+	uint32_t prev = regions[index].prevPhysical;
+	if (prev != INVALID && regions[prev].isFree) {
+		removeFree(prev);
+		merge(prev, index);
+		index = prev;
+	}
+
+	insertFree(index);
+}
+
+void VEmemoryBlock::addStats(VEallocatorStats& stats) const {
+	stats.blockCount++;
+	stats.allocationCount += allocationCount;
+	stats.blockBytes += size;
+	stats.usedBytes += usedBytes;
+	stats.freeBytes += size - usedBytes;
+
+	for (uint32_t i = 0; i != INVALID; i = regions[i].nextPhysical) {
+		if (regions[i].isFree) {
+			stats.freeRegionCount++;
+			stats.largestFreeRegion = std::max(stats.largestFreeRegion, regions[i].size);
+		}
+	}
+}
+
+uint32_t VEmemoryBlock::newRegion() {
+	if (!unusedRegions.empty()) {
+		uint32_t index = unusedRegions.back();
+		unusedRegions.pop_back();
+		return index;
+	}
+
+	regions.push_back({});
+	return static_cast<uint32_t>(regions.size() - 1);
+}
+
+void VEmemoryBlock::insertFree(uint32_t index) {
+	uint32_t fl, sl;
+	mapping(regions[index].size, fl, sl);
+
+	uint32_t head = freeLists[fl][sl];
+	regions[index].isFree = true;
+	regions[index].prevFree = INVALID;
+	regions[index].nextFree = head;
+	if (head != INVALID) {
+		regions[head].prevFree = index;
+	}
+
+	freeLists[fl][sl] = index;
+	flBitmap |= 1ull << fl;
+	slBitmap[fl] |= 1u << sl;
+}
+
+void VEmemoryBlock::removeFree(uint32_t index) {
+	uint32_t fl, sl;
+	mapping(regions[index].size, fl, sl);
+
+	auto& region = regions[index];
+	if (region.prevFree != INVALID) {
+		regions[region.prevFree].nextFree = region.nextFree;
+	}
+	else {
+		freeLists[fl][sl] = region.nextFree;
+	}
+
+	if (region.nextFree != INVALID) {
+		regions[region.nextFree].prevFree = region.prevFree;
+	}
+
+	if (freeLists[fl][sl] == INVALID) {
+		slBitmap[fl] &= ~(1u << sl);
+		if (!slBitmap[fl]) {
+			flBitmap &= ~(1ull << fl);
+		}
+	}
+}
+
+// index region을 [0, size) / [size, end) 로 나누고 뒤쪽 region을 반환한다
+uint32_t VEmemoryBlock::split(uint32_t index, vk::DeviceSize size) {
+	uint32_t tail = newRegion();
+
+	auto& front = regions[index];
+	auto& back = regions[tail];
+
+	back.offset = front.offset + size;
+	back.size = front.size - size;
+	back.isFree = true;
+	back.prevPhysical = index;
+	back.nextPhysical = front.nextPhysical;
+
+	if (front.nextPhysical != INVALID) {
+		regions[front.nextPhysical].prevPhysical = tail;
+	}
+
+	front.nextPhysical = tail;
+	front.size = size;
+
+	return tail;
+}
+
+void VEmemoryBlock::merge(uint32_t front, uint32_t back) {
+	regions[front].size += regions[back].size;
+	regions[front].nextPhysical = regions[back].nextPhysical;
+
+	if (regions[back].nextPhysical != INVALID) {
+		regions[regions[back].nextPhysical].prevPhysical = front;
+	}
+
+	unusedRegions.push_back(back);
+}
+
+// ------------- Allocator ----------------
+
+void VEallocator::init(vk::PhysicalDevice physicalDevice, vk::Device device, vk::DeviceSize preferredBlockSize) {
+	this->device = device;
+	this->preferredBlockSize = preferredBlockSize;
+
+	memoryProperties = physicalDevice.getMemoryProperties();
+	bufferImageGranularity = physicalDevice.getProperties().limits.bufferImageGranularity;
+}
+
+void VEallocator::cleanUp() {
+	std::lock_guard lock(mutex);
+
+	for (auto& pools : blocks) {
+		for (auto& pool : pools) {
+			for (auto& block : pool) {
+				device.freeMemory(block->memory);
+			}
+			pool.clear();
+		}
+	}
+
+	for (auto& allocation : dedicatedAllocations) {
+		device.freeMemory(allocation.memory);
+	}
+	dedicatedAllocations.clear();
+}
+
+uint32_t VEallocator::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
+	uint64_t key = (static_cast<uint64_t>(typeFilter) << 32) | static_cast<VkMemoryPropertyFlags>(properties);
+
+	std::lock_guard lock(mutex);
+
+	auto cached = memoryTypeCache.find(key);
+	if (cached != memoryTypeCache.end()) {
+		return cached->second;
+	}
+
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+		if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+			memoryTypeCache[key] = i;
+			return i;
+		}
+	}
+
+	throw std::runtime_error("failed to find suitable memory type");
+}
+
+VEallocation VEallocator::allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear) {
+	uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+	vk::DeviceSize blockSize = getBlockSize(memoryType);
+
+	std::lock_guard lock(mutex);
+
+	VEallocation allocation{};
+
+	// 큰 리소스는 block을 낭비하지 않도록 dedicated allocation
+	if (requirements.size > blockSize / 2) {
+		vk::MemoryAllocateInfo allocInfo{
+			.allocationSize = requirements.size,
+			.memoryTypeIndex = memoryType,
+		};
+
+		allocation.memory = device.allocateMemory(allocInfo);
+		allocation.size = requirements.size;
+		allocation.mapped = mapIfHostVisible(allocation.memory, memoryType);
+		allocation.memoryType = memoryType;
+
+		dedicatedAllocations.push_back(allocation);
+		return allocation;
+	}
+
+	auto& pool = blocks[memoryType][(linear || bufferImageGranularity <= 1) ? 0 : 1];
+
+	for (auto& block : pool) {
+		if (block->allocate(requirements.size, requirements.alignment, allocation)) {
+			return allocation;
+		}
+	}
+
+	vk::MemoryAllocateInfo allocInfo{
+		.allocationSize = blockSize,
+		.memoryTypeIndex = memoryType,
+	};
+
+	auto memory = device.allocateMemory(allocInfo);
+	pool.push_back(std::make_unique<VEmemoryBlock>(memory, blockSize, memoryType, mapIfHostVisible(memory, memoryType)));
+
+	if (!pool.back()->allocate(requirements.size, requirements.alignment, allocation)) {
+		throw std::runtime_error("failed to sub-allocate from a new memory block");
+	}
+
+	return allocation;
+}
+
+void VEallocator::free(VEallocation& allocation) {
+	if (!allocation.memory) return;
+
+	std::lock_guard lock(mutex);
+
+	if (!allocation.block) {
+		device.freeMemory(allocation.memory);
+		std::erase_if(dedicatedAllocations, [&](const VEallocation& item) {
+			return item.memory == allocation.memory;
+		});
+	}
+	else {
+		auto block = allocation.block;
+		block->free(allocation.region);
+
+		// 빈 block은 하나만 남겨두고 반환한다 (할당 / 해제 반복 시 thrashing 방지)
+		for (auto& pool : blocks[block->memoryType]) {
+			auto found = std::find_if(pool.begin(), pool.end(), [&](const auto& item) { return item.get() == block; });
+			if (found == pool.end() || !block->empty()) continue;
+
+			auto emptyCount = std::count_if(pool.begin(), pool.end(), [](const auto& item) { return item->empty(); });
+			if (emptyCount > 1) {
+				device.freeMemory(block->memory);
+				pool.erase(found);
+			}
+			break;
+		}
+	}
+
+	allocation = VEallocation{};
+}
+
+VEallocatorStats VEallocator::getStats() {
+	std::lock_guard lock(mutex);
+
+	VEallocatorStats stats{};
+
+	for (auto& pools : blocks) {
+		for (auto& pool : pools) {
+			for (auto& block : pool) {
+				block->addStats(stats);
+			}
+		}
+	}
+
+	stats.dedicatedCount = static_cast<uint32_t>(dedicatedAllocations.size());
+	for (auto& allocation : dedicatedAllocations) {
+		stats.dedicatedBytes += allocation.size;
+	}
+
+	return stats;
+}
+
+void VEallocator::printStats(std::ostream& out) {
+	auto stats = getStats();
+	constexpr double MB = 1024.0 * 1024.0;
+
+	out << std::fixed << std::setprecision(2)
+		<< "memory: " << stats.blockCount << " blocks (" << stats.blockBytes / MB << " MB), "
+		<< stats.dedicatedCount << " dedicated (" << stats.dedicatedBytes / MB << " MB), "
+		<< stats.allocationCount << " sub-allocations, "
+		<< "utilization " << stats.utilization() * 100.0f << " %, "
+		<< "fragmentation " << stats.fragmentation() * 100.0f << " % (" << stats.freeRegionCount << " free regions)\n"
+		<< std::defaultfloat;
+}
+
+// heap이 작은 경우(ex. integrated GPU의 device local heap) block 하나가 heap을 독차지하지 않도록 한다
+vk::DeviceSize VEallocator::getBlockSize(uint32_t memoryType) const {
+	auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryType].heapIndex].size;
+	if (heapSize <= 1024ull * 1024 * 1024) {
+		return std::min(preferredBlockSize, alignUp(heapSize / 8, 16));
+	}
+
+	return preferredBlockSize;
+}
+
+void* VEallocator::mapIfHostVisible(vk::DeviceMemory memory, uint32_t memoryType) {
+	if (memoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible) {
+		return device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+	}
+
+	return nullptr;
+}
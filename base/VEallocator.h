@@ -0,0 +1,146 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <ostream>
+
+// ------------- Device Memory Allocator ----------------
+//
+// vkAllocateMemory는 개수 상한(maxMemoryAllocationCount)이 있고 호출 비용도 크다.
+// memory type 별로 큰 block을 할당해두고 그 안을 TLSF(Two-Level Segregated Fit)로 나누어 사용한다.
+//	- first level	: size의 최상위 bit (2의 거듭제곱 구간)
+//	- second level	: 각 구간을 SL_COUNT개로 균등 분할
+// 두 단계 모두 bitmap으로 관리하므로 free region 검색은 O(1)이다.
+//
+// bufferImageGranularity > 1 인 device에서는 linear(buffer) / optimal(image) 리소스를
+// 서로 다른 block에 두어 granularity 충돌이 생기지 않도록 한다.
+// block 크기의 절반 이상인 리소스는 dedicated allocation으로 따로 할당한다.
+
+class VEmemoryBlock;
+
+struct VEallocation {
+	vk::DeviceMemory memory;
+	vk::DeviceSize offset{ 0 };
+	vk::DeviceSize size{ 0 };
+	void* mapped{ nullptr };	// host visible 메모리는 persistent map 되어있다
+
+	uint32_t memoryType{ 0 };
+	VEmemoryBlock* block{ nullptr };	// nullptr -> dedicated allocation
+	uint32_t region{ 0 };
+};
+
+struct VEallocatorStats {
+	uint32_t blockCount{ 0 };
+	uint32_t dedicatedCount{ 0 };
+	uint32_t allocationCount{ 0 };
+	uint32_t freeRegionCount{ 0 };
+
+	vk::DeviceSize blockBytes{ 0 };			// block 으로 할당받은 전체 크기
+	vk::DeviceSize dedicatedBytes{ 0 };
+	vk::DeviceSize usedBytes{ 0 };			// block 내에서 사용중인 크기
+	vk::DeviceSize freeBytes{ 0 };
+	vk::DeviceSize largestFreeRegion{ 0 };
+
+	// block 메모리 중 실제로 사용중인 비율
+	float utilization() const {
+		return blockBytes ? static_cast<float>(usedBytes) / blockBytes : 1.0f;
+	}
+
+	// 0 : free 영역이 하나로 모여있음, 1에 가까울수록 잘게 쪼개져 있음
+	float fragmentation() const {
+		return freeBytes ? 1.0f - static_cast<float>(largestFreeRegion) / freeBytes : 0.0f;
+	}
+};
+
+class VEmemoryBlock {
+public:
+	static constexpr uint32_t INVALID = ~0u;
+
+	VEmemoryBlock(vk::DeviceMemory memory, vk::DeviceSize size, uint32_t memoryType, void* mapped);
+
+	bool allocate(vk::DeviceSize size, vk::DeviceSize alignment, VEallocation& allocation);
+	void free(uint32_t region);
+
+	bool empty() const { return allocationCount == 0; }
+	void addStats(VEallocatorStats& stats) const;
+
+	vk::DeviceMemory memory;
+	vk::DeviceSize size;
+	uint32_t memoryType;
+	void* mapped;
+private:
+	static constexpr uint32_t SL_LOG2 = 4;
+	static constexpr uint32_t SL_COUNT = 1 << SL_LOG2;
+	static constexpr uint32_t FL_SHIFT = SL_LOG2 + 4;
+	static constexpr vk::DeviceSize SMALL_SIZE = vk::DeviceSize(1) << FL_SHIFT;	// 이보다 작은 크기는 fl = 0 에서 선형 분할
+	static constexpr uint32_t FL_COUNT = 64 - FL_SHIFT + 1;
+	static constexpr vk::DeviceSize MIN_REGION = 16;
+
+	struct Region {
+		vk::DeviceSize offset;
+		vk::DeviceSize size;
+		bool isFree;
+
+		uint32_t prevPhysical;	// 주소상 인접한 region (coalescing 용)
+		uint32_t nextPhysical;
+		uint32_t prevFree;		// 같은 free list 내 연결
+		uint32_t nextFree;
+	};
+
+	std::vector<Region> regions;
+	std::vector<uint32_t> unusedRegions;
+
+	uint64_t flBitmap{ 0 };
+	uint32_t slBitmap[FL_COUNT]{};
+	uint32_t freeLists[FL_COUNT][SL_COUNT];
+
+	uint32_t allocationCount{ 0 };
+	vk::DeviceSize usedBytes{ 0 };
+
+	static void mapping(vk::DeviceSize size, uint32_t& fl, uint32_t& sl);
+	uint32_t findFree(vk::DeviceSize size) const;
+
+	uint32_t newRegion();
+	void insertFree(uint32_t index);
+	void removeFree(uint32_t index);
+	uint32_t split(uint32_t index, vk::DeviceSize size);
+	void merge(uint32_t front, uint32_t back);
+};
+
+class VEallocator {
+public:
+	void init(vk::PhysicalDevice physicalDevice, vk::Device device, vk::DeviceSize preferredBlockSize = 64 * 1024 * 1024);
+	void cleanUp();
+
+	// memory properties는 init 시점에 한번만 읽어두고 재사용한다
+	uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
+	const vk::PhysicalDeviceMemoryProperties& getMemoryProperties() const { return memoryProperties; }
+
+	// linear : buffer, linear tiling image / false : optimal tiling image
+	VEallocation allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear = true);
+	void free(VEallocation& allocation);
+
+	VEallocatorStats getStats();
+	void printStats(std::ostream& out);
+private:
+	vk::Device device;
+	vk::PhysicalDeviceMemoryProperties memoryProperties;
+	vk::DeviceSize bufferImageGranularity{ 1 };
+	vk::DeviceSize preferredBlockSize{ 0 };
+
+	std::unordered_map<uint64_t, uint32_t> memoryTypeCache;
+
+	// [memory type][linear ? 0 : 1]
+	std::vector<std::unique_ptr<VEmemoryBlock>> blocks[VK_MAX_MEMORY_TYPES][2];
+	std::vector<VEallocation> dedicatedAllocations;
+
+	std::mutex mutex;
+
+	vk::DeviceSize getBlockSize(uint32_t memoryType) const;
+	void* mapIfHostVisible(vk::DeviceMemory memory, uint32_t memoryType);
+};
@@ -1,5 +1,8 @@
 #include "VEbase.h"
 
+// vk:: 호출이 쓰는 VULKAN_HPP_DEFAULT_DISPATCHER (VULKAN_HPP_DISPATCH_LOADER_DYNAMIC, 전체에서 하나)
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+
 std::vector<const char*> validationLayers{
 	"VK_LAYER_KHRONOS_validation",
 };
@@ -13,54 +16,256 @@ std::vector<const char*> deviceExtensions{
 };
 
 void VEbase::init() {
-	setUpWindow(title);
-	glfwSetKeyCallback(window, key_callback);
+	if (settings.framesInFlight > 0) {
+		framesInFlight = settings.framesInFlight;
+	}
+	else {
+		framesInFlight = settings.latencyMode == VElatencyMode::eLow ? 1 :
+			settings.latencyMode == VElatencyMode::eThroughput ? 3 : 2;
+	}
 
-	updateInstanceExtensions();
+	jobs.init(settings.threads);
+
+	if (!settings.headless) {
+		setUpWindow(title, settings.width, settings.height);
+		glfwSetKeyCallback(window, key_callback);
+	}
+
+	// instance 생성 전에 쓰는 global 함수 (vkEnumerateInstance*, vkCreateInstance)
+	VULKAN_HPP_DEFAULT_DISPATCHER.init(vkGetInstanceProcAddr);
+
+	updateInstanceExtensions(settings.headless);
+	updateDeviceExtensions(settings.headless);
 
 	createInstance();
 	setUpDebugMessenger();
-	createSurface();
+	if (!settings.headless) {
+		createSurface();
+	}
 	pickPhysicalDevice();
 	createLogicalDevice();
+	allocator.init(physicalDevice, device);
+	deletionQueue.init(device, allocator);
+	staging.init(device, allocator, transferQueue, queueFamilies.transferFamily.value(), queueFamilies.graphicsFamily.value());
+	pipelineCache.init(physicalDevice, device, settings.pipelineCachePath,
+		enabledFeatures.pipelineCreationFeedback);
+	gpuProfiler.init(physicalDevice, device, queueFamilies.graphicsFamily.value(), framesInFlight);
+	gpuProfiler.setCapture(!settings.tracePath.empty());
+	commandRecorder.init(device, queueFamilies.graphicsFamily.value(), framesInFlight, jobs);
+	{
+		std::vector<VEdescriptorAllocator::PoolSizeRatio> ratios{
+			{ vk::DescriptorType::eUniformBuffer, 1.0f },
+			{ vk::DescriptorType::eUniformBufferDynamic, 0.5f },
+			{ vk::DescriptorType::eStorageBuffer, 1.0f },
+			{ vk::DescriptorType::eCombinedImageSampler, 2.0f },
+		};
+		descriptorAllocator.init(device, ratios);
+		frameDescriptors.init(device, framesInFlight, ratios);
+	}
+	if (bindlessEnabled) {
+		bindless.init(physicalDevice, device);
+	}
+	uniformRing.init(physicalDevice, device, allocator, framesInFlight);
+	renderGraph.init(device, allocator, &gpuProfiler);
+	renderGraph.setRetire([this](std::function<void()> destroy) { retire(std::move(destroy)); });
+	updateFramebufferSize();
+	framebufferResized = false;
 	createSwapChain();
 	createSwapChainImageViews();
-	createFences();
+	createFrameTimeline();
 }
 
 void VEbase::mainLoop() {
+	VE_PROFILE_FUNCTION();
+
+	if (settings.headless) {
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		for (uint32_t frame = 0; frame < settings.headlessFrames; frame++) {
+			jobs.pumpMain();
+			simulate();
+			{
+				VE_PROFILE_ZONE("drawFrame");
+				drawFrame();
+			}
+			VE_PROFILE_FRAME();
+		}
+
+		device.waitIdle();
+
+		auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+		std::cout << "headless: " << settings.headlessFrames << " frames in " << elapsed << " s ("
+			<< settings.headlessFrames / elapsed << " frames/s)\n";
+		allocator.printStats(std::cout);
+		printMemoryBudget(std::cout);
+		return;
+	}
+
+	if (settings.renderThread) {
+		renderLoop();
+		return;
+	}
+
 	while (!glfwWindowShouldClose(window)) {
+		// window 관련 호출은 main thread에서만 한다 (다른 thread는 jobs.runOnMain으로 넘긴다)
 		glfwPollEvents();
+		jobs.pumpMain();
 		keyHandle();
+		updateFramebufferSize();
+		simulate();
 
-		drawFrame();
+		{
+			VE_PROFILE_ZONE("drawFrame");
+			drawFrame();
+		}
+		VE_PROFILE_FRAME();
 	}
 
 	device.waitIdle();
 }
 
+// main thread는 event / simulate, render thread는 drawFrame
+void VEbase::renderLoop() {
+	simulate();	// 첫 frame의 상태
+
+	rendering = true;
+	std::thread renderThread([this]() {
+		jobs.attachThread();	// recordParallel 중 job 실행
+
+		while (rendering.load(std::memory_order_acquire)) {
+			{
+				std::lock_guard lock(renderMutex);
+				renderFrameCount++;
+			}
+			renderStarted.notify_one();
+
+			{
+				VE_PROFILE_ZONE("drawFrame");
+				drawFrame();
+			}
+			VE_PROFILE_FRAME();
+		}
+
+		jobs.detachThread();
+	});
+
+	uint64_t simulatedFrame = 0;
+	while (!glfwWindowShouldClose(window)) {
+		glfwPollEvents();
+		jobs.pumpMain();
+		keyHandle();
+		updateFramebufferSize();
+
+		// render thread가 다음 frame을 시작하면 그 다음 frame을 simulate 한다
+		// 그 전에는 event만 처리하며 잠깐씩 기다린다 (입력 지연이 렌더링 시간에 묶이지 않는다)
+		std::unique_lock lock(renderMutex);
+		if (renderStarted.wait_for(lock, std::chrono::milliseconds(2), [&] { return renderFrameCount > simulatedFrame; })) {
+			simulatedFrame = renderFrameCount;
+			lock.unlock();
+
+			VE_PROFILE_ZONE("simulate");
+			simulate();
+		}
+	}
+
+	rendering = false;
+	renderThread.join();
+
+	device.waitIdle();
+}
+
+void VEbase::updateFramebufferSize() {
+	if (settings.headless) {
+		framebufferWidth = static_cast<int>(settings.width);
+		framebufferHeight = static_cast<int>(settings.height);
+		return;
+	}
+
+	int width{}, height{};
+	glfwGetFramebufferSize(window, &width, &height);
+
+	if (width != framebufferWidth || height != framebufferHeight) {
+		framebufferWidth = width;
+		framebufferHeight = height;
+		framebufferResized = true;
+	}
+}
+
 void VEbase::cleanUpBase() {
+	destroyFrameTimeline();
+
+	for (auto semaphore : presentReadySemaphores) {
+		device.destroySemaphore(semaphore);
+	}
+	presentReadySemaphores.clear();
+
 	for (int i = 0; i < swapChainImageViews.size(); i++) {
 		device.destroyImageView(swapChainImageViews[i]);
 	}
 
-	device.destroySwapchainKHR(swapChain);
+	if (settings.headless) {
+		destroyOffscreenTargets();
+	}
+	else {
+		device.destroySwapchainKHR(swapChain);
+	}
+
+	renderGraph.cleanUp();
+	deletionQueue.printStats(std::cout);
+	deletionQueue.cleanUp();
+
+	gpuProfiler.printStats(std::cout);
+	if (!settings.tracePath.empty()) {
+		// CPU zone은 VE_ENABLE_PROFILER 빌드에서만 기록된다
+		auto events = VEprofiler::get().getTraceEvents();
+		auto& gpuEvents = gpuProfiler.getTraceEvents();
+		events.insert(events.end(), gpuEvents.begin(), gpuEvents.end());
+
+		writeChromeTrace(settings.tracePath, events);
+	}
+	gpuProfiler.cleanUp();
+
+	commandRecorder.printStats(std::cout);
+	commandRecorder.cleanUp();
+
+	descriptorAllocator.printStats(std::cout, "descriptor allocator");
+	descriptorAllocator.cleanUp();
+	frameDescriptors.printStats(std::cout);
+	frameDescriptors.cleanUp();
+	if (bindlessEnabled) {
+		bindless.printStats(std::cout);
+		bindless.cleanUp();
+	}
+	jobs.cleanUp();
+
+	pipelineCache.save();
+	pipelineCache.printStats(std::cout);
+	pipelineCache.cleanUp();
+
+	uniformRing.printStats(std::cout);
+	uniformRing.cleanUp();
+	staging.cleanUp();
+	allocator.cleanUp();
 	device.destroy();
 
 	if (enableValidationLayers) {
 		DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 	}
 
-	instance.destroySurfaceKHR(surface);
+	if (!settings.headless) {
+		instance.destroySurfaceKHR(surface);
+	}
 	instance.destroy();
 
-	cleanUpWindow();
+	if (!settings.headless) {
+		cleanUpWindow();
+	}
 }
 
 void VEbase::createInstance() {
 	vk::ApplicationInfo appInfo{
 		.pApplicationName = title,
-		.apiVersion = vk::makeApiVersion(0, 1, 0, 0),
+		.apiVersion = vk::makeApiVersion(0, 1, 2, 0),	// timeline semaphore (1.2 core)
 	};
 
 	vk::InstanceCreateInfo instanceInfo{
@@ -83,23 +288,47 @@ void VEbase::createInstance() {
 	}
 
 	instance = vk::createInstance(instanceInfo);
+
+	// instance 함수와 extension 함수 (debug utils, surface 등)
+	VULKAN_HPP_DEFAULT_DISPATCHER.init(instance);
 }
 
+// 조건을 만족하는 device 중 점수가 가장 높은 것 (같으면 먼저 나온 것)
 void VEbase::pickPhysicalDevice() {
 	auto candidates{ instance.enumeratePhysicalDevices() };
-	
+
 	for (auto candidate : candidates) {
-		if (isDeviceSuitable(candidate, surface)) {
-			physicalDevice = candidate;
+		auto candidateCapabilities = queryDeviceCapabilities(candidate, surface, deviceExtensions);
+
+		std::cout << "device : " << candidateCapabilities.properties.deviceName.data() << " ("
+			<< vk::to_string(candidateCapabilities.properties.deviceType) << ", "
+			<< (candidateCapabilities.deviceLocalBytes >> 20) << " MB) ";
+		if (candidateCapabilities.suitable) {
+			std::cout << "score " << candidateCapabilities.score << "\n";
+		}
+		else {
+			std::cout << "not suitable : " << candidateCapabilities.reason << "\n";
+		}
+
+		if (candidateCapabilities.suitable && candidateCapabilities.score > capabilities.score) {
+			capabilities = std::move(candidateCapabilities);
 		}
 	}
+
+	if (!capabilities.suitable) {
+		throw std::runtime_error("failed to find a suitable GPU");
+	}
+
+	physicalDevice = capabilities.physicalDevice;
+	std::cout << "selected device : " << capabilities.properties.deviceName.data() << "\n";
 }
 
 void VEbase::createLogicalDevice() {
-	auto indices{ findQueueFamilies(physicalDevice, surface) };
+	auto indices{ capabilities.queueFamilies };
+	queueFamilies = indices;
 
 	std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos{};
-	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value(), indices.transferFamily.value() };
 
 	float priority = 1.0f;
 
@@ -116,41 +345,147 @@ void VEbase::createLogicalDevice() {
 	vk::PhysicalDeviceFeatures features{
 			//.logicOp = vk::True,
 	};
+	vk::PhysicalDeviceVulkan12Features features12{
+		.timelineSemaphore = vk::True,
+	};
+	vk::PhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+	vk::PhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+	vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+	vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+
+	enabledDeviceExtensions = deviceExtensions;
+
+	void** next = &features12.pNext;
+	auto chain = [&](auto& feature) {
+		*next = &feature;
+		next = &feature.pNext;
+	};
+
+	// 성능에 관련된 기능은 지원하면 켜 둔다 (사용 여부는 subsystem이 enabledFeatures를 보고 정한다)
+	auto& supported = capabilities.supported;
+	enabledFeatures = VEdeviceFeatures{ .timelineSemaphore = true };
+
+	if (supported.synchronization2) {
+		enabledDeviceExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		synchronization2Features.synchronization2 = vk::True;
+		chain(synchronization2Features);
+		enabledFeatures.synchronization2 = true;
+	}
+
+	if (supported.dynamicRendering) {
+		// VK_KHR_dynamic_rendering은 VK_KHR_depth_stencil_resolve를 (1.2에서는 core) 필요로 한다
+		enabledDeviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+		dynamicRenderingFeatures.dynamicRendering = vk::True;
+		chain(dynamicRenderingFeatures);
+		enabledFeatures.dynamicRendering = true;
+	}
+
+	if (supported.descriptorIndexing) {
+		VEbindless::enableFeatures(features12);
+		enabledFeatures.descriptorIndexing = true;
+	}
+
+	if (supported.bufferDeviceAddress) {
+		features12.bufferDeviceAddress = vk::True;
+		enabledFeatures.bufferDeviceAddress = true;
+	}
+
+	if (supported.drawIndirectCount) {
+		features12.drawIndirectCount = vk::True;
+		enabledFeatures.drawIndirectCount = true;
+	}
+
+	if (supported.multiDrawIndirect) {
+		features.multiDrawIndirect = vk::True;
+		features.drawIndirectFirstInstance = vk::True;
+		enabledFeatures.multiDrawIndirect = true;
+	}
+
+	if (supported.memoryBudget) {
+		enabledDeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		enabledFeatures.memoryBudget = true;
+	}
+
+	if (supported.pipelineCreationFeedback) {
+		enabledDeviceExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+		enabledFeatures.pipelineCreationFeedback = true;
+	}
+
+	// low latency mode : present id + present wait (둘 다 지원하는 경우에만)
+	if (settings.latencyMode == VElatencyMode::eLow && !settings.headless && supported.presentWait) {
+		enabledDeviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+		enabledDeviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+		presentIdFeatures.presentId = vk::True;
+		presentWaitFeatures.presentWait = vk::True;
+		chain(presentIdFeatures);
+		chain(presentWaitFeatures);
+		enabledFeatures.presentWait = true;
+	}
+	presentWaitEnabled = enabledFeatures.presentWait;
+
+	// bindless : descriptor indexing (Vulkan 1.2 feature)
+	bindlessEnabled = settings.bindless && enabledFeatures.descriptorIndexing;
+	if (settings.bindless && !bindlessEnabled) {
+		std::cout << "bindless : descriptor indexing is not supported, falling back to descriptor sets\n";
+	}
+	if (bindlessEnabled && !hasShader("bindless/bindless.vert.spv")) {
+		std::cout << "bindless : bindless/bindless.vert.spv not found (compile shaders/bindless), falling back to descriptor sets\n";
+		bindlessEnabled = false;
+	}
+
+	enabledFeatures.print(std::cout);
+
 	vk::DeviceCreateInfo deviceInfo{
+		.pNext = &features12,
 		.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
 		.pQueueCreateInfos = queueCreateInfos.data(),
-		.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()),
-		.ppEnabledExtensionNames = deviceExtensions.data(),
+		.enabledExtensionCount = static_cast<uint32_t>(enabledDeviceExtensions.size()),
+		.ppEnabledExtensionNames = enabledDeviceExtensions.data(),
 		// geometry Shader, tessellationShader, samplerAnistrophy etc...
 		.pEnabledFeatures = &features,
 	};
 
 	device = physicalDevice.createDevice(deviceInfo);
+
+	// device 함수를 vkGetDeviceProcAddr로 다시 읽어 loader trampoline을 거치지 않고 driver로 바로 간다
+	// (device가 하나이므로 전역 dispatcher에 넣어도 된다)
+	VULKAN_HPP_DEFAULT_DISPATCHER.init(device);
+
 	device.getQueue(indices.graphicsFamily.value(), 0, &graphicsQueue);
 	device.getQueue(indices.presentFamily.value(), 0, &presentQueue);
+	device.getQueue(indices.transferFamily.value(), 0, &transferQueue);
 }
 
 void VEbase::createSurface() {
+#ifdef _WIN32
 	VkWin32SurfaceCreateInfoKHR surfaceInfo{
 		.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
 		.hinstance = GetModuleHandle(nullptr),
 		.hwnd = glfwGetWin32Window(window),
 	};
 
-	VK_CHECK_RESULT(vkCreateWin32SurfaceKHR(instance, &surfaceInfo, nullptr, &surface));
+	VK_CHECK_RESULT(VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateWin32SurfaceKHR(instance, &surfaceInfo, nullptr, &surface));
+#else
+	VK_CHECK_RESULT(glfwCreateWindowSurface(instance, window, nullptr, &surface));
+#endif
 }
 
 void VEbase::createSwapChain() {
-	SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice, surface);
+	if (settings.headless) {
+		createOffscreenTargets();
+		createPresentSemaphores();
+		return;
+	}
 
-	vk::SurfaceFormatKHR surfaceFormat = chooseSwapChainSurfaceFormat(swapChainSupport.formats);
-	vk::PresentModeKHR presentMode = chooseSwapChainPresentMode(swapChainSupport.presentModes);
-	vk::Extent2D extent = chooseSwapChainExtent(swapChainSupport.capabilities);
+	// format / present mode는 device 선택 때 조회해 둔 것, 현재 크기 등은 매번 조회한다
+	auto surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(surface);
 
-	uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
-	if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
-		imageCount = swapChainSupport.capabilities.maxImageCount;
-	}
+	vk::SurfaceFormatKHR surfaceFormat = chooseSwapChainSurfaceFormat(capabilities.surfaceFormats);
+	vk::PresentModeKHR presentMode = chooseSwapChainPresentMode(capabilities.presentModes);
+	vk::Extent2D extent = chooseSwapChainExtent(surfaceCapabilities);
+
+	uint32_t imageCount = getSwapChainImageCount(&surfaceCapabilities);
 
 	vk::SwapchainCreateInfoKHR swapChainInfo{
 		.surface = surface,
@@ -163,7 +498,7 @@ void VEbase::createSwapChain() {
 		.presentMode = presentMode,
 	};
 
-	auto indices{ findQueueFamilies(physicalDevice, surface) };
+	auto& indices = queueFamilies;
 	uint32_t queueFamilyIndices[]{ indices.graphicsFamily.value(), indices.presentFamily.value() };
 
 	if (indices.graphicsFamily != indices.presentFamily) {
@@ -175,13 +510,15 @@ void VEbase::createSwapChain() {
 		swapChainInfo.imageSharingMode = vk::SharingMode::eExclusive;
 	}
 
-	swapChainInfo.preTransform = swapChainSupport.capabilities.currentTransform;	// rotation or flip of the view
+	swapChainInfo.preTransform = surfaceCapabilities.currentTransform;	// rotation or flip of the view
 	swapChainInfo.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque;
 
 	swapChainInfo.presentMode = presentMode;
 	swapChainInfo.clipped = vk::True;
+	swapChainInfo.oldSwapchain = swapChain;	// 재생성 : 이전 swapchain은 retire 된다 (최초 생성 시 null)
 
 	swapChain = device.createSwapchainKHR(swapChainInfo);
+	presentId = 0;	// present id는 swapchain 마다 새로 시작한다
 
 	auto images = device.getSwapchainImagesKHR(swapChain);
 	
@@ -189,6 +526,16 @@ void VEbase::createSwapChain() {
 
 	swapChainFormat = surfaceFormat.format;
 	swapChainExtent = extent;
+
+	createPresentSemaphores();
+}
+
+// image 수가 늘어난 만큼만 만든다 (이전 swapchain의 present가 아직 기다릴 수 있으므로 줄이거나 다시 만들지 않는다)
+void VEbase::createPresentSemaphores()
+{
+	while (presentReadySemaphores.size() < swapChainImages.size()) {
+		presentReadySemaphores.push_back(device.createSemaphore({}));
+	}
 }
 
 void VEbase::createSwapChainImageViews()
@@ -219,33 +566,292 @@ void VEbase::createSwapChainImageViews()
 	}
 }
 
+// GPU 전체를 기다리지 않는다
+// 새 swapchain은 oldSwapchain으로 이전 것을 넘겨받아 만들고, 이전 image view, framebuffer는
+// 지금까지 submit 된 frame이 끝난 뒤, 이전 swapchain은 framesInFlight frame 더 뒤에 파괴한다 (retire)
 void VEbase::recreateSwapChain()
 {
-	int width{}, height{};
-	glfwGetFramebufferSize(window, &width, &height);
-	while (width == 0 || height == 0) {
-		glfwGetFramebufferSize(window, &width, &height);
-		glfwWaitEvents();
+	// 최소화 중에는 크기가 0이다
+	if (!settings.headless) {
+		if (jobs.isMainThread()) {
+			updateFramebufferSize();
+			while (framebufferWidth == 0 || framebufferHeight == 0) {
+				glfwWaitEvents();
+				updateFramebufferSize();
+			}
+		}
+		else {
+			// render thread : main thread가 크기를 갱신할 때까지 (또는 종료될 때까지) 기다린다
+			while ((framebufferWidth == 0 || framebufferHeight == 0) && rendering) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		}
 	}
 
-	device.waitIdle();
-
-	destroyFences();
-	createFences();
-
 	destroyFrameBuffers();
 
-	for (auto i = 0; i < swapChainImageViews.size(); i++) {
-		device.destroyImageView(swapChainImageViews[i]);
+	for (auto view : swapChainImageViews) {
+		retire(view);
+	}
+	swapChainImageViews.clear();
+
+	if (settings.headless) {
+		for (auto i = 0; i < swapChainImages.size(); i++) {
+			retire(swapChainImages[i]);
+			retire(offscreenAllocations[i]);
+		}
+		swapChainImages.clear();
+		offscreenAllocations.clear();
 	}
 
-	device.destroySwapchainKHR(swapChain);
+	// headless에서는 swapChain이 null이다
+	auto oldSwapChain = swapChain;
 
 	createSwapChain();
+
+	// 이전 swapchain에는 아직 present가 queue에 남아 있을 수 있고, frame timeline은 graphics submit만 추적한다.
+	// 그래서 지금 frame이 아니라 framesInFlight frame 뒤에 파괴한다. 그때까지 새 swapchain에서 framesInFlight 번
+	// acquire / submit / present가 같은 queue 순서로 지나가므로, 그보다 앞에 queue 된 이전 swapchain의
+	// present는 presentation engine이 모두 받아갔다.
+	// (VK_EXT_swapchain_maintenance1의 present fence를 쓰면 정확히 알 수 있지만 여기서는 쓰지 않는다)
+	// deletion queue는 순서를 지키므로 그 사이에 retire 된 object도 같이 늦춰진다.
+	if (oldSwapChain) {
+		deletionQueue.push(getFrameNumber() + framesInFlight, oldSwapChain);
+	}
+
 	createSwapChainImageViews();
 	createFrameBuffers();
 }
 
+// headless 모드에서는 swapchain image 대신 offscreen image를 순서대로 돌려가며 사용한다.
+// drawFrame이 그대로 동작하도록 빈 submit으로 semaphore를 signal / wait 해준다.
+vk::Result VEbase::acquireNextImage(vk::Semaphore signalSemaphore, uint32_t& imageIndex)
+{
+	VE_PROFILE_FUNCTION();
+
+	if (settings.headless) {
+		imageIndex = offscreenIndex;
+		offscreenIndex = (offscreenIndex + 1) % static_cast<uint32_t>(swapChainImages.size());
+
+		vk::SubmitInfo submitInfo{
+			.signalSemaphoreCount = 1,
+			.pSignalSemaphores = &signalSemaphore,
+		};
+		graphicsQueue.submit(submitInfo, nullptr);
+
+		return vk::Result::eSuccess;
+	}
+
+	// out of date / suboptimal을 예외 대신 결과 값으로 받는다
+	auto result = VULKAN_HPP_DEFAULT_DISPATCHER.vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, signalSemaphore, nullptr, &imageIndex);
+	return static_cast<vk::Result>(result);
+}
+
+vk::Result VEbase::presentImage(vk::Semaphore waitSemaphore, uint32_t imageIndex)
+{
+	VE_PROFILE_FUNCTION();
+
+	if (settings.headless) {
+		vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+		vk::SubmitInfo submitInfo{
+			.waitSemaphoreCount = 1,
+			.pWaitSemaphores = &waitSemaphore,
+			.pWaitDstStageMask = &waitStage,
+		};
+		graphicsQueue.submit(submitInfo, nullptr);
+
+		return vk::Result::eSuccess;
+	}
+
+	vk::PresentIdKHR presentIdInfo{
+		.swapchainCount = 1,
+		.pPresentIds = &presentId,
+	};
+
+	if (presentWaitEnabled) {
+		presentId++;
+	}
+
+	vk::PresentInfoKHR presentInfo{
+		.pNext = presentWaitEnabled ? &presentIdInfo : nullptr,
+		.waitSemaphoreCount = 1,
+		.pWaitSemaphores = &waitSemaphore,
+		.swapchainCount = 1,
+		.pSwapchains = &swapChain,
+		.pImageIndices = &imageIndex,
+	};
+
+	auto result = VULKAN_HPP_DEFAULT_DISPATCHER.vkQueuePresentKHR((VkQueue&)presentQueue, &(VkPresentInfoKHR&)presentInfo);
+	return static_cast<vk::Result>(result);
+}
+
+void VEbase::printMemoryBudget(std::ostream& out) const
+{
+	if (!enabledFeatures.memoryBudget) return;
+
+	auto memory = physicalDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+	auto& properties = memory.get<vk::PhysicalDeviceMemoryProperties2>().memoryProperties;
+	auto& budget = memory.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+
+	for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+		out << "memory heap " << i << ": " << (budget.heapUsage[i] >> 20) << " / " << (budget.heapBudget[i] >> 20) << " MB"
+			<< ((properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) ? " (device local)" : "") << "\n";
+	}
+}
+
+bool VEbase::isExtensionEnabled(const char* name) const
+{
+	for (auto enabled : enabledDeviceExtensions) {
+		if (strcmp(enabled, name) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// frame command buffer를 graphics queue에 submit 한다
+// 이번 frame 까지 쌓인 upload를 먼저 flush 하고, waitOnGraphics로 요청된 upload 대기와
+// queue family ownership acquire를 함께 submit 한다
+// 완료 시 frame timeline에 frame 번호를 signal 한다
+void VEbase::submitFrame(vk::CommandBuffer commandBuffer, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore)
+{
+	staging.flush();
+
+	VEsubmitBatch batch{};
+	batch.wait(waitSemaphore, vk::PipelineStageFlagBits::eColorAttachmentOutput);
+	batch.commandBuffers.push_back(commandBuffer);
+	batch.signal(signalSemaphore);
+	batch.signal(frameTimeline, getFrameNumber());
+
+	staging.prepareGraphicsSubmit(batch);
+
+	batch.submit(graphicsQueue);
+	submittedFrame++;
+}
+
+// acquire 실패 등으로 submit 하지 않은 frame은 번호를 소비하지 않으므로 다음 호출에서 같은 번호를 쓴다
+uint32_t VEbase::beginFrame()
+{
+	auto frame = getFrameNumber();
+	if (frame > framesInFlight) {
+		VE_PROFILE_ZONE("waitForFrame");
+		waitForFrame(frame - framesInFlight);
+	}
+
+	// 직전 present가 화면에 나갈 때까지 기다려 입력 ~ 출력 사이의 대기열을 없앤다
+	if (presentWaitEnabled && presentId > 0) {
+		VE_PROFILE_ZONE("waitForPresent");
+		// out of date 등은 다음 acquire에서 처리하므로 결과는 무시한다
+		VULKAN_HPP_DEFAULT_DISPATCHER.vkWaitForPresentKHR(device, swapChain, presentId, 100'000'000);
+	}
+
+	// 끝난 frame의 object 파괴 (한 frame에 몰리지 않도록 개수 제한)
+	isFrameRetired(submittedFrame);
+	deletionQueue.collect(retiredFrame);
+
+	auto frameIndex = static_cast<uint32_t>(frame % framesInFlight);
+	frameDescriptors.beginFrame(frameIndex);
+	uniformRing.beginFrame(frameIndex);
+
+	return frameIndex;
+}
+
+bool VEbase::isFrameRetired(uint64_t frame)
+{
+	if (frame <= retiredFrame) return true;
+
+	retiredFrame = device.getSemaphoreCounterValue(frameTimeline);
+	return frame <= retiredFrame;
+}
+
+void VEbase::waitForFrame(uint64_t frame)
+{
+	if (isFrameRetired(frame)) return;
+
+	vk::SemaphoreWaitInfo waitInfo{
+		.semaphoreCount = 1,
+		.pSemaphores = &frameTimeline,
+		.pValues = &frame,
+	};
+	std::ignore = device.waitSemaphores(waitInfo, UINT64_MAX);
+
+	retiredFrame = std::max(retiredFrame, frame);
+}
+
+void VEbase::retire(VEdeletionQueue::Object object)
+{
+	deletionQueue.push(getFrameNumber(), std::move(object));
+}
+
+// destroyBuffer의 deferred 버전
+void VEbase::retireBuffer(vk::Buffer& buffer, VEallocation& allocation)
+{
+	retire(buffer);
+	retire(allocation);
+
+	buffer = nullptr;
+}
+
+// Renderpass의 color attachment finalLayout
+// headless 에서는 present 할 일이 없으므로 readback 가능한 layout으로 둔다
+vk::ImageLayout VEbase::getPresentLayout() const
+{
+	return settings.headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
+}
+
+void VEbase::createOffscreenTargets()
+{
+	swapChainFormat = vk::Format::eR8G8B8A8Unorm;
+	swapChainExtent = vk::Extent2D{
+		.width = settings.width,
+		.height = settings.height,
+	};
+
+	auto imageCount = getSwapChainImageCount();
+	swapChainImages.resize(imageCount);
+	offscreenAllocations.resize(imageCount);
+
+	for (uint32_t i = 0; i < imageCount; i++) {
+		vk::ImageCreateInfo imageInfo{
+			.imageType = vk::ImageType::e2D,
+			.format = swapChainFormat,
+			.extent = {
+				.width = swapChainExtent.width,
+				.height = swapChainExtent.height,
+				.depth = 1,
+			},
+			.mipLevels = 1,
+			.arrayLayers = 1,
+			.samples = vk::SampleCountFlagBits::e1,
+			.tiling = vk::ImageTiling::eOptimal,
+			.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+			.sharingMode = vk::SharingMode::eExclusive,
+			.initialLayout = vk::ImageLayout::eUndefined,
+		};
+
+		swapChainImages[i] = device.createImage(imageInfo);
+
+		auto memRequirements = device.getImageMemoryRequirements(swapChainImages[i]);
+
+		offscreenAllocations[i] = allocator.allocate(memRequirements, vk::MemoryPropertyFlagBits::eDeviceLocal, false);
+		device.bindImageMemory(swapChainImages[i], offscreenAllocations[i].memory, offscreenAllocations[i].offset);
+	}
+
+	offscreenIndex = 0;
+}
+
+void VEbase::destroyOffscreenTargets()
+{
+	for (auto i = 0; i < swapChainImages.size(); i++) {
+		device.destroyImage(swapChainImages[i]);
+		allocator.free(offscreenAllocations[i]);
+	}
+
+	swapChainImages.clear();
+	offscreenAllocations.clear();
+}
+
 vk::SurfaceFormatKHR VEbase::chooseSwapChainSurfaceFormat(std::vector<vk::SurfaceFormatKHR> availableFormats) {
 	for (auto format : availableFormats) {
 		if (format.format == vk::Format::eB8G8R8A8Srgb &&
@@ -272,8 +878,9 @@ vk::Extent2D VEbase::chooseSwapChainExtent(const vk::SurfaceCapabilitiesKHR& cap
 		return capabilities.currentExtent;
 	}
 	else {
-		int width, height;
-		glfwGetFramebufferSize(window, &width, &height);
+		// glfw는 main thread 전용이므로 main thread가 갱신해 둔 값을 쓴다
+		int width = framebufferWidth;
+		int height = framebufferHeight;
 
 		vk::Extent2D actualExtent{
 			.width = static_cast<uint32_t>(width),
@@ -301,15 +908,7 @@ vk::ShaderModule VEbase::createShaderModule(std::vector<char>& code)
 
 uint32_t VEbase::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties)
 {
-	auto memProperties = physicalDevice.getMemoryProperties();
-	
-	for (auto i = 0; i < memProperties.memoryTypeCount; i++) {
-		if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-			return i;
-		}
-	}
-
-	throw std::runtime_error("failed to find suitable memory type");
+	return allocator.findMemoryType(typeFilter, properties);
 }
 
 void VEbase::drawFrame()
@@ -324,28 +923,39 @@ void VEbase::destroyFrameBuffers()
 {
 }
 
-void VEbase::createFences()
+// frame in flight 마다 image를 하나씩 잡고 있어도 acquire가 막히지 않도록 한 장 더 둔다
+uint32_t VEbase::getSwapChainImageCount(const vk::SurfaceCapabilitiesKHR* capabilities) const
 {
-	vk::FenceCreateInfo fenceInfo{
-			.flags = vk::FenceCreateFlagBits::eSignaled,
-	};
+	uint32_t imageCount = settings.swapChainImageCount > 0 ? settings.swapChainImageCount : framesInFlight + 1;
 
-	inflightFences.resize(MAX_FRAMES_IN_FLIGHT);
-
-	for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-		inflightFences[i] = device.createFence(fenceInfo);
+	if (capabilities) {
+		imageCount = std::max(imageCount, capabilities->minImageCount);
+		if (capabilities->maxImageCount > 0) {
+			imageCount = std::min(imageCount, capabilities->maxImageCount);
+		}
 	}
+
+	return imageCount;
 }
 
-void VEbase::destroyFences()
+void VEbase::createFrameTimeline()
 {
-	for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-		device.destroyFence(inflightFences[i]);
-	}
+	vk::SemaphoreTypeCreateInfo typeCI{
+		.semaphoreType = vk::SemaphoreType::eTimeline,
+		.initialValue = 0,
+	};
 
+	frameTimeline = device.createSemaphore({ .pNext = &typeCI });
+	submittedFrame = 0;
+	retiredFrame = 0;
 }
 
-void VEbase::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& deviceMemory) {
+void VEbase::destroyFrameTimeline()
+{
+	device.destroySemaphore(frameTimeline);
+}
+
+void VEbase::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, VEallocation& allocation) {
 	vk::BufferCreateInfo bufferCI{
 		.size = size,
 		.usage = usage,
@@ -356,108 +966,79 @@ void VEbase::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::M
 
 	auto memRequirements = device.getBufferMemoryRequirements(buffer);
 
-	vk::MemoryAllocateInfo allocInfo{
-		.allocationSize = memRequirements.size,
-		.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties),
-	};
-
-	deviceMemory = device.allocateMemory(allocInfo);
-	device.bindBufferMemory(buffer, deviceMemory, 0);
-
 	// GPU 메모리에는 할당 상한이 존재한다 (maxMemoryAllocationCount)
-	// 따라서 대량의 오브젝트를 할당할 경우에 offset을 통해 구분하는 방법이 있다.
-	// 관련 라이브러리로 VMA(VulkanMemoryAllocator)가 있다.
-}
-
-void VEbase::copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size) {
-	vk::CommandBufferAllocateInfo allocInfo{
-		.commandPool = commandPool,
-		.level = vk::CommandBufferLevel::ePrimary,
-		.commandBufferCount = 1,
-	};
-
-	auto commandBuffer = device.allocateCommandBuffers(allocInfo).front();
-
-	commandBuffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
-
-	vk::BufferCopy copyRegion{
-		.size = size,
-	};
-	commandBuffer.copyBuffer(srcBuffer, dstBuffer, copyRegion);
-	commandBuffer.end();
-
-	vk::SubmitInfo submitInfo{
-		.commandBufferCount = 1,
-		.pCommandBuffers = &commandBuffer,
-	};
-
-	// Graphics & Compute Queue Family는 암시적으로 Transfer 지원해서 그대로 사용해도 상관 없음
-	graphicsQueue.submit(submitInfo, nullptr);
-	graphicsQueue.waitIdle();
-
-	device.freeCommandBuffers(commandPool, commandBuffer);
+	// 따라서 allocator가 미리 할당한 큰 block 내에서 offset으로 구분하여 사용한다.
+	allocation = allocator.allocate(memRequirements, properties);
+	device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
 }
 
-bool isDeviceSuitable(vk::PhysicalDevice device, vk::SurfaceKHR surface) {
-	auto indice = findQueueFamilies(device, surface);
-
-	bool extensionSupported = checkDeviceExtensionSupport(device);
-
-	bool swapChainAdequate = false;
-	if (extensionSupported) {
-		SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device, surface);
-		swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
-	}
+void VEbase::destroyBuffer(vk::Buffer& buffer, VEallocation& allocation) {
+	device.destroyBuffer(buffer);
+	allocator.free(allocation);
 
-	return indice.isComplete() && extensionSupported && swapChainAdequate;
+	buffer = nullptr;
 }
 
-QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice device, vk::SurfaceKHR surface) {
-	auto queueFamilies{ device.getQueueFamilyProperties() };
+VEsettings parseSettings(int argc, char** argv) {
+	VEsettings settings{};
 
-	QueueFamilyIndices indices{};
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
 
-	int i{};
-	for (const auto& queueFamily : queueFamilies) {
-		if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) {
-			indices.graphicsFamily = i;
+		if (arg == "--headless") {
+			settings.headless = true;
 		}
-
-		// present support
-		if (device.getSurfaceSupportKHR(i, surface)) {
-			indices.presentFamily = i;
+		else if (arg == "--frames" && hasValue) {
+			settings.headlessFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
 		}
-
-		if (indices.isComplete()) {
-			break;
+		else if (arg == "--width" && hasValue) {
+			settings.width = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--height" && hasValue) {
+			settings.height = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--pipeline-cache" && hasValue) {
+			settings.pipelineCachePath = argv[++i];
+		}
+		else if (arg == "--trace" && hasValue) {
+			settings.tracePath = argv[++i];
+		}
+		else if (arg == "--output" && hasValue) {
+			settings.outputPath = argv[++i];
+		}
+		else if (arg == "--latency" && hasValue) {
+			std::string mode = argv[++i];
+			if (mode == "low") settings.latencyMode = VElatencyMode::eLow;
+			else if (mode == "balanced") settings.latencyMode = VElatencyMode::eBalanced;
+			else if (mode == "throughput") settings.latencyMode = VElatencyMode::eThroughput;
+			else std::cout << "unknown latency mode : " << mode << "\n";
+		}
+		else if (arg == "--frames-in-flight" && hasValue) {
+			settings.framesInFlight = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+		}
+		else if (arg == "--swapchain-images" && hasValue) {
+			settings.swapChainImageCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--single-thread") {
+			settings.renderThread = false;
+		}
+		else if (arg == "--bindless") {
+			settings.bindless = true;
+		}
+		else if (arg == "--threads" && hasValue) {
+			settings.threads = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else {
+			std::cout << "unknown argument : " << arg << "\n";
 		}
-
-		i++;
-	}
-
-	return indices;
-}
-
-bool checkDeviceExtensionSupport(vk::PhysicalDevice device) {
-	auto availbleExtensions = device.enumerateDeviceExtensionProperties();
-
-	std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
-
-	for (const auto& extension : availbleExtensions) {
-		requiredExtensions.erase(extension.extensionName);
 	}
 
-	return requiredExtensions.empty();
+	return settings;
 }
 
-SwapChainSupportDetails querySwapChainSupport(vk::PhysicalDevice device, vk::SurfaceKHR surface) {
-	SwapChainSupportDetails details{
-		.capabilities = device.getSurfaceCapabilitiesKHR(surface),
-		.formats = device.getSurfaceFormatsKHR(surface),
-		.presentModes = device.getSurfacePresentModesKHR(surface),
-	};
-
-	return details;
+bool hasShader(const std::string& shader) {
+	return std::ifstream(getShadersPath() + shader, std::ios::binary).is_open();
 }
 
 std::vector<char> readFileAsBinary(const std::string& filename) {
@@ -487,19 +1068,25 @@ const std::string getShadersPath()
 	return "shaders/";
 };
 
-void updateInstanceExtensions() {
-	uint32_t count;
-	auto glExtensions = glfwGetRequiredInstanceExtensions(&count);
-	for (uint32_t i{}; i < count; i++) {
-		bool flag = false;
-		for (auto item : instanceExtensions) {
-			if (strcmp(item, glExtensions[i]) == 0) {
-				flag = true;
+void updateInstanceExtensions(bool headless) {
+	if (headless) {
+		// window system 없이 동작하므로 surface extension도 필요 없다
+		instanceExtensions.clear();
+	}
+	else {
+		uint32_t count;
+		auto glExtensions = glfwGetRequiredInstanceExtensions(&count);
+		for (uint32_t i{}; i < count; i++) {
+			bool flag = false;
+			for (auto item : instanceExtensions) {
+				if (strcmp(item, glExtensions[i]) == 0) {
+					flag = true;
+				}
 			}
-		}
 
-		if (!flag) {
-			instanceExtensions.push_back(glExtensions[i]);
+			if (!flag) {
+				instanceExtensions.push_back(glExtensions[i]);
+			}
 		}
 	}
 
@@ -508,6 +1095,15 @@ void updateInstanceExtensions() {
 	}
 }
 
+void updateDeviceExtensions(bool headless) {
+	if (headless) {
+		// swapchain을 만들지 않으므로 VK_KHR_swapchain이 없는 device도 사용 가능
+		std::erase_if(deviceExtensions, [](const char* name) {
+			return strcmp(name, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+		});
+	}
+}
+
 bool checkValidationLayerSupport() {
 	auto availableLayers{ vk::enumerateInstanceLayerProperties() };
 
@@ -515,7 +1111,7 @@ bool checkValidationLayerSupport() {
 		bool layerFound{ false };
 
 		for (auto layerProperty : availableLayers) {
-			if (strcmp(layerProperty.layerName, layerName)) {
+			if (strcmp(layerProperty.layerName, layerName) == 0) {
 				layerFound = true;
 				break;
 			}
@@ -556,7 +1152,7 @@ void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& create
 }
 
 VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pDebugMessenger) {
-	auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
+	auto func = VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateDebugUtilsMessengerEXT;
 	if (func != nullptr) {
 		return func(instance, pCreateInfo, pAllocator, pDebugMessenger);
 	}
@@ -566,7 +1162,7 @@ VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMes
 }
 
 void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT debugMessenger, const VkAllocationCallbacks* pAllocator) {
-	auto func = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
+	auto func = VULKAN_HPP_DEFAULT_DISPATCHER.vkDestroyDebugUtilsMessengerEXT;
 	if (func != nullptr) {
 		func(instance, debugMessenger, pAllocator);
 	}
@@ -1,12 +1,13 @@
 #pragma once
 
-#define VK_USE_PLATFORM_WIN32_KHR
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
 #include <vulkan/vulkan.hpp>
 
 #include "GLFW/glfw3.h"
+#ifdef _WIN32
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include "GLFW/glfw3native.h"
+#endif
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -22,6 +23,22 @@
 #include <algorithm>
 #include <fstream>
 #include <chrono>
+#include <functional>
+
+#include "VEallocator.h"
+#include "VEbindless.h"
+#include "VEcommandRecorder.h"
+#include "VEdeletionQueue.h"
+#include "VEdescriptor.h"
+#include "VEdevice.h"
+#include "VEjobSystem.h"
+#include "VEtripleBuffer.h"
+#include "VEuniformRing.h"
+#include "VEstaging.h"
+#include "VEpipelineCache.h"
+#include "VErenderGraph.h"
+#include "VEgpuProfiler.h"
+#include "VEprofiler.h"
 
 // ------------- Window ---------------------
 
@@ -32,6 +49,51 @@ const int KEYS = GLFW_KEY_MENU + 1;
 
 static bool pressed[KEYS]{ false };
 
+// ------------- Settings ---------------------
+
+// 실행 인자로 바꿀 수 있는 설정들
+//	--headless			: window / surface / swapchain 없이 offscreen image ring에 렌더링
+//	--frames <n>		: headless 모드에서 렌더링할 frame 수
+//	--width, --height	: window 또는 offscreen image 크기
+//	--pipeline-cache <path>	: pipeline cache 파일 경로
+//	--trace <path>		: 종료 시 profiler 구간을 Chrome trace JSON으로 저장
+//	--output <path>		: 결과 파일 경로 (benchmark)
+//	--latency <low | balanced | throughput>	: frame in flight / swapchain image 기본값
+//	--frames-in-flight <n>, --swapchain-images <n>	: latency mode 기본값 대신 직접 지정
+//	--threads <n>		: job system thread 수, main 포함 (default hardware thread 수)
+//	--single-thread		: render thread 없이 main thread에서 event 처리와 렌더링을 번갈아 한다
+//	--bindless			: descriptor indexing을 지원하면 bindless descriptor set을 만든다
+
+// low			: 1 frame in flight, VK_KHR_present_wait가 있으면 이전 present가 화면에 나갈 때까지 기다린다
+// balanced		: 2 frames in flight
+// throughput	: 3 frames in flight
+enum class VElatencyMode {
+	eLow,
+	eBalanced,
+	eThroughput,
+};
+
+struct VEsettings {
+	bool headless = false;
+	uint32_t headlessFrames = 300;
+
+	VElatencyMode latencyMode = VElatencyMode::eBalanced;
+	uint32_t framesInFlight = 0;		// 0 -> latency mode 기본값
+	uint32_t swapChainImageCount = 0;	// 0 -> framesInFlight + 1 (surface 허용 범위로 맞춘다)
+	uint32_t threads = 0;				// job system thread 수 (0 -> hardware thread 수)
+	bool renderThread = true;			// window 모드에서 렌더링을 별도 thread로 (headless는 항상 한 thread)
+	bool bindless = false;				// 지원하지 않는 device에서는 꺼진다 (bindlessEnabled)
+
+	uint32_t width = WIDTH;
+	uint32_t height = HEIGHT;
+
+	std::string pipelineCachePath = "pipeline_cache.bin";
+	std::string tracePath;
+	std::string outputPath;
+};
+
+VEsettings parseSettings(int argc, char** argv);
+
 class VEwindow {
 protected:
 	GLFWwindow* window;
@@ -65,37 +127,45 @@ const bool enableValidationLayers = true;
 	}																												\
 }
 
-const int MAX_FRAMES_IN_FLIGHT = 2;
-
-struct QueueFamilyIndices {
-	std::optional<uint32_t> graphicsFamily;
-	std::optional<uint32_t> presentFamily;
-
-	bool isComplete() {
-		return graphicsFamily.has_value() && presentFamily.has_value();
-	}
-};
-
-struct SwapChainSupportDetails {
-	vk::SurfaceCapabilitiesKHR capabilities;
-	std::vector<vk::SurfaceFormatKHR> formats;
-	std::vector<vk::PresentModeKHR> presentModes;
-};
-
 class VEbase : public VEwindow {
 private:
 	const char* title;
+
+	// headless 모드에서 swapchain 대신 사용하는 offscreen color image ring
+	std::vector<VEallocation> offscreenAllocations;
+	uint32_t offscreenIndex{ 0 };
+
+	void createOffscreenTargets();
+	void destroyOffscreenTargets();
 protected:
+	VEsettings settings;
+
+	// worker thread + main thread affinity queue (init을 호출한 thread가 main)
+	VEjobSystem jobs;
+
 	VkDebugUtilsMessengerEXT debugMessenger;
 	
 	vk::Instance instance;
 	vk::PhysicalDevice physicalDevice;
-	VkSurfaceKHR surface;
+	VkSurfaceKHR surface{ VK_NULL_HANDLE };	// headless에서는 null (device 선택이 present 검사를 건너뛴다)
 
 	vk::Device device;
+	std::vector<const char*> enabledDeviceExtensions;
+	VEallocator allocator;
+	VEdeletionQueue deletionQueue;
+	VEstagingRing staging;
+	VEpipelineCache pipelineCache;
+	VErenderGraph renderGraph;
+	VEgpuProfiler gpuProfiler;
 	
+	QueueFamilyIndices queueFamilies;
+
+	// pickPhysicalDevice에서 조회한 device 정보와 createLogicalDevice에서 실제로 켠 기능
+	VEdeviceCapabilities capabilities;
+	VEdeviceFeatures enabledFeatures;
 	vk::Queue graphicsQueue;
 	vk::Queue presentQueue;
+	vk::Queue transferQueue;
 
 	vk::SwapchainKHR swapChain;
 	vk::Format swapChainFormat;
@@ -103,21 +173,67 @@ protected:
 	std::vector<vk::Image> swapChainImages;
 	std::vector<vk::ImageView> swapChainImageViews;
 
-	vk::CommandPool commandPool;
-	std::vector<vk::CommandBuffer> commandBuffers;
+	// frame slot / thread 별 command pool (primary + parallel secondary)
+	VEcommandRecorder commandRecorder;
+
+	// descriptor set 할당 (pool이 모자라면 이어 붙인다)
+	//	descriptorAllocator	: material 등 오래 쓰는 set (cleanUpBase에서 pool과 함께 해제)
+	//	frameDescriptors	: 그 frame 에만 쓰는 set (beginFrame에서 slot 단위로 reset)
+	VEdescriptorAllocator descriptorAllocator;
+	VEframeDescriptors frameDescriptors;
+
+	// frame 마다 쓰고 버리는 uniform data (eUniformBufferDynamic + dynamic offset)
+	VEuniformRing uniformRing;
+
+	// settings.bindless && device 지원 시에만 init 된다
+	VEbindless bindless;
+	bool bindlessEnabled{ false };
 
-	std::vector<vk::Fence> inflightFences;
+	// frame 별 resource 개수 (settings에서 정해지며 init 이후 유효)
+	uint32_t framesInFlight{ 2 };
+
+	// acquire -> submit : frame slot 별 (예제가 만든다, slot 재사용은 frame timeline이 보장한다)
 	std::vector<vk::Semaphore> renderSemaphores;
+	// submit -> present : swapchain image 별 (createSwapChain에서 만든다)
+	// present가 wait를 끝냈는지는 frame timeline으로 알 수 없으므로 slot이 아니라 image 번호로 쓴다
+	// (같은 image를 다시 acquire 했다면 그 image의 이전 present는 semaphore를 소비했다)
 	std::vector<vk::Semaphore> presentReadySemaphores;
+
+	// Frame pacing : graphics queue의 timeline semaphore 하나로 frame 완료를 추적한다
+	// frame N (1부터)의 submit이 끝나면 값 N이 signal 된다
+	vk::Semaphore frameTimeline;
+	uint64_t submittedFrame{ 0 };	// 마지막으로 submit 한 frame 번호
+	uint64_t retiredFrame{ 0 };		// GPU 완료가 확인된 마지막 frame 번호 (cache)
+
+	// render thread 모드
+	//	main thread	: event 처리, keyHandle, simulate() (frame 상태를 VEtripleBuffer로 넘긴다)
+	//	render thread	: drawFrame() (acquire ~ present)
+	// render thread가 frame N을 시작하면 main thread가 frame N+1의 simulate를 시작한다.
+	// glfw는 main thread에서만 부를 수 있으므로 framebuffer 크기는 main thread가 갱신해 둔다.
+	std::atomic<bool> rendering{ false };
+	std::atomic<uint64_t> renderFrameCount{ 0 };	// render thread가 시작한 frame 수
+	std::mutex renderMutex;
+	std::condition_variable renderStarted;
+	std::atomic<int> framebufferWidth{ 0 };
+	std::atomic<int> framebufferHeight{ 0 };
+
+	// low latency mode : present id를 붙여 present하고 다음 frame 시작 전에 화면 출력을 기다린다
+	bool presentWaitEnabled{ false };
+	uint64_t presentId{ 0 };
 public:
-	VEbase(const char* title) {
+	VEbase(const char* title, const VEsettings& settings = {}) {
 		this->title = title;
+		this->settings = settings;
 	}
 
-	bool framebufferResized = false;
+	std::atomic<bool> framebufferResized{ false };
 
 	void init();
 	void mainLoop();
+	void renderLoop();
+	// main thread에서 렌더링 전에 frame 마다 호출 (render thread 모드에서는 이전 frame의 렌더링과 겹친다)
+	virtual void simulate() {}
+	void updateFramebufferSize();
 	void cleanUpBase();
 
 	void createInstance();
@@ -127,8 +243,18 @@ public:
 	void createSurface();
 	void createSwapChain();
 	void createSwapChainImageViews();
+	void createPresentSemaphores();
 	void recreateSwapChain();
 
+	// swapchain / offscreen ring 공용 acquire, present
+	vk::Result acquireNextImage(vk::Semaphore signalSemaphore, uint32_t& imageIndex);
+	vk::Result presentImage(vk::Semaphore waitSemaphore, uint32_t imageIndex);
+	void submitFrame(vk::CommandBuffer commandBuffer, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore);
+	bool isExtensionEnabled(const char* name) const;
+	// heap 별 사용량 / budget (VK_EXT_memory_budget을 켠 경우에만)
+	void printMemoryBudget(std::ostream& out) const;
+	vk::ImageLayout getPresentLayout() const;
+
 	vk::SurfaceFormatKHR chooseSwapChainSurfaceFormat(std::vector<vk::SurfaceFormatKHR>);
 	vk::PresentModeKHR chooseSwapChainPresentMode(std::vector<vk::PresentModeKHR>);
 	vk::Extent2D chooseSwapChainExtent(const vk::SurfaceCapabilitiesKHR&);
@@ -140,24 +266,35 @@ public:
 	virtual void createFrameBuffers();
 	virtual void destroyFrameBuffers();
 
-	virtual void createFences();
-	virtual void destroyFences();
+	// 이번 frame이 쓸 slot의 이전 frame이 끝날 때까지 기다리고 slot 번호를 돌려준다 (0 ~ framesInFlight - 1)
+	uint32_t beginFrame();
+	// 기록중인 (다음에 submit 될) frame 번호
+	uint64_t getFrameNumber() const { return submittedFrame + 1; }
+	bool isFrameRetired(uint64_t frame);
+	void waitForFrame(uint64_t frame);
+
+	// 기록중인 frame까지 GPU가 사용할 수 있는 object를 그 frame이 끝난 뒤 파괴한다 (deletionQueue)
+	void retire(VEdeletionQueue::Object object);
+	void retireBuffer(vk::Buffer&, VEallocation&);
 
-	void createBuffer(vk::DeviceSize, vk::BufferUsageFlags, vk::MemoryPropertyFlags, vk::Buffer&, vk::DeviceMemory&);
-	void copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
+	uint32_t getSwapChainImageCount(const vk::SurfaceCapabilitiesKHR* capabilities = nullptr) const;
+
+	void createFrameTimeline();
+	void destroyFrameTimeline();
+
+	void createBuffer(vk::DeviceSize, vk::BufferUsageFlags, vk::MemoryPropertyFlags, vk::Buffer&, VEallocation&);
+	void destroyBuffer(vk::Buffer&, VEallocation&);
 };
 
 const std::string getShadersPath();
 
-void updateInstanceExtensions();
+void updateInstanceExtensions(bool headless);
+void updateDeviceExtensions(bool headless);
 bool checkValidationLayerSupport();
-bool checkDeviceExtensionSupport(vk::PhysicalDevice);
-
-bool isDeviceSuitable(vk::PhysicalDevice, vk::SurfaceKHR);
-QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice, vk::SurfaceKHR);
-SwapChainSupportDetails querySwapChainSupport(vk::PhysicalDevice, vk::SurfaceKHR);
 
 std::vector<char> readFileAsBinary(const std::string&);
+// getShadersPath() 아래에 compile 된 shader (.spv)가 있는지 (예 : "push/push.vert.spv")
+bool hasShader(const std::string&);
 
 // -------- Debug Messenger (Validation Layer) ---------
 
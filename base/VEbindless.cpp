@@ -0,0 +1,195 @@
+#include "VEbindless.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// ---- Handle Allocator ----
+
+void VEhandleAllocator::init(uint32_t capacity) {
+	this->capacity = capacity;
+	next = 0;
+	freeList.clear();
+}
+
+uint32_t VEhandleAllocator::allocate() {
+	// 최근에 돌려받은 번호부터 재사용한다
+	if (!freeList.empty()) {
+		auto handle = freeList.back();
+		freeList.pop_back();
+		return handle;
+	}
+
+	if (next == capacity) {
+		return INVALID;
+	}
+
+	return next++;
+}
+
+void VEhandleAllocator::free(uint32_t handle) {
+	if (handle == INVALID || handle >= next) return;
+
+	freeList.push_back(handle);
+}
+
+// ---- Bindless ----
+
+bool VEbindless::isSupported(const vk::PhysicalDeviceVulkan12Features& supported) {
+	return supported.descriptorIndexing &&
+		supported.runtimeDescriptorArray &&
+		supported.descriptorBindingPartiallyBound &&
+		supported.descriptorBindingUpdateUnusedWhilePending &&
+		supported.descriptorBindingStorageBufferUpdateAfterBind &&
+		supported.descriptorBindingSampledImageUpdateAfterBind &&
+		supported.shaderStorageBufferArrayNonUniformIndexing &&
+		supported.shaderSampledImageArrayNonUniformIndexing;
+}
+
+void VEbindless::enableFeatures(vk::PhysicalDeviceVulkan12Features& features) {
+	features.descriptorIndexing = vk::True;
+	features.runtimeDescriptorArray = vk::True;
+	features.descriptorBindingPartiallyBound = vk::True;
+	features.descriptorBindingUpdateUnusedWhilePending = vk::True;
+	features.descriptorBindingStorageBufferUpdateAfterBind = vk::True;
+	features.descriptorBindingSampledImageUpdateAfterBind = vk::True;
+	features.shaderStorageBufferArrayNonUniformIndexing = vk::True;
+	features.shaderSampledImageArrayNonUniformIndexing = vk::True;
+}
+
+void VEbindless::init(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t maxBuffers, uint32_t maxTextures) {
+	this->device = device;
+
+	// update after bind 한도 (software ICD는 작을 수 있다)
+	auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+	auto& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+	maxBuffers = std::min({ maxBuffers,
+		limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+		limits.maxDescriptorSetUpdateAfterBindStorageBuffers });
+	maxTextures = std::min({ maxTextures,
+		limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+		limits.maxDescriptorSetUpdateAfterBindSampledImages,
+		limits.maxDescriptorSetUpdateAfterBindSamplers });
+
+	buffers.init(maxBuffers);
+	textures.init(maxTextures);
+
+	auto stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+
+	vk::DescriptorSetLayoutBinding bindings[2]{
+		{
+			.binding = eStorageBuffers,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.descriptorCount = maxBuffers,
+			.stageFlags = stages,
+		},
+		{
+			.binding = eTextures,
+			.descriptorType = vk::DescriptorType::eCombinedImageSampler,
+			.descriptorCount = maxTextures,
+			.stageFlags = stages,
+		},
+	};
+
+	vk::DescriptorBindingFlags bindingFlag = vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+		vk::DescriptorBindingFlagBits::ePartiallyBound |
+		vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+	vk::DescriptorBindingFlags bindingFlags[2]{ bindingFlag, bindingFlag };
+
+	vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+		.bindingCount = 2,
+		.pBindingFlags = bindingFlags,
+	};
+
+	layout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+		.pNext = &bindingFlagsInfo,
+		.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+		.bindingCount = 2,
+		.pBindings = bindings,
+	});
+
+	vk::DescriptorPoolSize poolSizes[2]{
+		{ .type = vk::DescriptorType::eStorageBuffer, .descriptorCount = maxBuffers },
+		{ .type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = maxTextures },
+	};
+
+	pool = device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+		.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+		.maxSets = 1,
+		.poolSizeCount = 2,
+		.pPoolSizes = poolSizes,
+	});
+
+	set = device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+		.descriptorPool = pool,
+		.descriptorSetCount = 1,
+		.pSetLayouts = &layout,
+	}).front();
+}
+
+void VEbindless::cleanUp() {
+	// set은 pool과 함께 해제된다
+	device.destroyDescriptorPool(pool);
+	device.destroyDescriptorSetLayout(layout);
+	pool = nullptr;
+	layout = nullptr;
+	set = nullptr;
+}
+
+uint32_t VEbindless::addBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range) {
+	auto index = buffers.allocate();
+	if (index == VEhandleAllocator::INVALID) {
+		throw std::runtime_error("bindless storage buffer slots are full");
+	}
+
+	vk::DescriptorBufferInfo bufferInfo{
+		.buffer = buffer,
+		.offset = offset,
+		.range = range,
+	};
+
+	device.updateDescriptorSets(vk::WriteDescriptorSet{
+		.dstSet = set,
+		.dstBinding = eStorageBuffers,
+		.dstArrayElement = index,
+		.descriptorCount = 1,
+		.descriptorType = vk::DescriptorType::eStorageBuffer,
+		.pBufferInfo = &bufferInfo,
+	}, nullptr);
+
+	return index;
+}
+
+uint32_t VEbindless::addTexture(vk::ImageView view, vk::Sampler sampler, vk::ImageLayout layout) {
+	auto index = textures.allocate();
+	if (index == VEhandleAllocator::INVALID) {
+		throw std::runtime_error("bindless texture slots are full");
+	}
+
+	vk::DescriptorImageInfo imageInfo{
+		.sampler = sampler,
+		.imageView = view,
+		.imageLayout = layout,
+	};
+
+	device.updateDescriptorSets(vk::WriteDescriptorSet{
+		.dstSet = set,
+		.dstBinding = eTextures,
+		.dstArrayElement = index,
+		.descriptorCount = 1,
+		.descriptorType = vk::DescriptorType::eCombinedImageSampler,
+		.pImageInfo = &imageInfo,
+	}, nullptr);
+
+	return index;
+}
+
+void VEbindless::bind(vk::CommandBuffer commandBuffer, vk::PipelineBindPoint bindPoint, vk::PipelineLayout pipelineLayout, uint32_t setIndex) const {
+	commandBuffer.bindDescriptorSets(bindPoint, pipelineLayout, setIndex, 1, &set, 0, nullptr);
+}
+
+void VEbindless::printStats(std::ostream& out) const {
+	out << "bindless: " << buffers.getUsedCount() << " / " << buffers.getCapacity() << " buffers, "
+		<< textures.getUsedCount() << " / " << textures.getCapacity() << " textures\n";
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include <ostream>
+#include <vector>
+
+// ------------- Bindless Descriptors ----------------
+//
+// descriptor indexing (Vulkan 1.2)으로 resource 종류 마다 큰 배열 binding 하나를 두고
+// 모든 buffer / texture를 한 descriptor set에 넣는다. shader는 draw 마다 받은 index로 배열을 읽는다.
+//	binding 0 : storage buffer 배열		(shader : layout(set = 0, binding = 0) buffer ... []);
+//	binding 1 : combined image sampler 배열	(shader : layout(set = 0, binding = 1) uniform sampler2D ...[]);
+// set은 frame 시작에 한 번만 bind 하면 되므로 draw 마다 bindDescriptorSets를 하지 않는다.
+//
+// binding은 update after bind + partially bound + update unused while pending 이므로
+//	- 쓰지 않는 slot은 비어있어도 되고
+//	- GPU가 set을 사용하는 중에도 (그 slot을 쓰지 않는 한) 새 slot을 기록할 수 있다.
+// slot 번호는 VEhandleAllocator가 나눠준다. remove 한 slot은 바로 재사용되므로
+// 마지막으로 사용한 frame이 끝난 뒤에 remove 해야 한다 (VEbase::retire로 넘긴다).
+
+// 0 ~ capacity-1 번호를 나눠주고 돌려받는다 (free list)
+class VEhandleAllocator {
+public:
+	static constexpr uint32_t INVALID = ~0u;
+
+	void init(uint32_t capacity);
+	uint32_t allocate();
+	void free(uint32_t handle);
+
+	uint32_t getCapacity() const { return capacity; }
+	uint32_t getUsedCount() const { return next - static_cast<uint32_t>(freeList.size()); }
+private:
+	uint32_t capacity{ 0 };
+	uint32_t next{ 0 };		// 한번도 나눠주지 않은 첫 번호
+	std::vector<uint32_t> freeList;
+};
+
+class VEbindless {
+public:
+	enum Binding : uint32_t {
+		eStorageBuffers = 0,
+		eTextures = 1,
+	};
+
+	// 필요한 descriptor indexing feature를 지원하는지 (createLogicalDevice에서 확인 후 켠다)
+	static bool isSupported(const vk::PhysicalDeviceVulkan12Features& supported);
+	static void enableFeatures(vk::PhysicalDeviceVulkan12Features& features);
+
+	// 개수는 device의 update after bind 한도로 줄어든다
+	void init(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t maxBuffers = 16384, uint32_t maxTextures = 4096);
+	void cleanUp();
+
+	uint32_t addBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = VK_WHOLE_SIZE);
+	uint32_t addTexture(vk::ImageView view, vk::Sampler sampler, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+	void removeBuffer(uint32_t index) { buffers.free(index); }
+	void removeTexture(uint32_t index) { textures.free(index); }
+
+	vk::DescriptorSetLayout getLayout() const { return layout; }
+	vk::DescriptorSet getSet() const { return set; }
+
+	void bind(vk::CommandBuffer commandBuffer, vk::PipelineBindPoint bindPoint, vk::PipelineLayout pipelineLayout, uint32_t setIndex = 0) const;
+
+	void printStats(std::ostream& out) const;
+private:
+	vk::Device device;
+	vk::DescriptorSetLayout layout;
+	vk::DescriptorPool pool;
+	vk::DescriptorSet set;
+
+	VEhandleAllocator buffers;
+	VEhandleAllocator textures;
+};
@@ -0,0 +1,865 @@
+#include "VEbvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VE_BVH_SSE
+#include <emmintrin.h>
+#endif
+
+// SAH bin 수 (축 마다)
+static constexpr uint32_t SAH_BINS = 16;
+
+// ---- AABB ----
+
+void VEaabb::expand(const VEaabb& other) {
+	min = glm::min(min, other.min);
+	max = glm::max(max, other.max);
+}
+
+void VEaabb::expand(const glm::vec3& point) {
+	min = glm::min(min, point);
+	max = glm::max(max, point);
+}
+
+float VEaabb::surfaceArea() const {
+	if (isEmpty()) return 0.0f;
+
+	auto size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+// ---- Node ----
+
+VEaabb VEbvhNode::getChildBounds(uint32_t slot) const {
+	return VEaabb{
+		.min = { minX[slot], minY[slot], minZ[slot] },
+		.max = { maxX[slot], maxY[slot], maxZ[slot] },
+	};
+}
+
+void VEbvhNode::setChildBounds(uint32_t slot, const VEaabb& bounds) {
+	minX[slot] = bounds.min.x;
+	minY[slot] = bounds.min.y;
+	minZ[slot] = bounds.min.z;
+	maxX[slot] = bounds.max.x;
+	maxY[slot] = bounds.max.y;
+	maxZ[slot] = bounds.max.z;
+}
+
+VEaabb VEbvhNode::getBounds() const {
+	VEaabb bounds;
+	for (uint32_t slot = 0; slot < 4; slot++) {
+		if (children[slot] != VEbvh::EMPTY) {
+			bounds.expand(getChildBounds(slot));
+		}
+	}
+	return bounds;
+}
+
+uint32_t VEbvhNode::getOccupiedMask() const {
+	uint32_t mask = 0;
+	for (uint32_t slot = 0; slot < 4; slot++) {
+		mask |= static_cast<uint32_t>(children[slot] != VEbvh::EMPTY) << slot;
+	}
+	return mask;
+}
+
+// ---- Node tests (자식 4개를 한 번에, 결과는 slot 별 bit) ----
+
+namespace {
+
+// 순회 stack : 대부분 앞쪽 고정 배열에서 끝나고, 넘치면 heap으로 이어간다
+template <typename T>
+class TraversalStack {
+public:
+	void push(const T& value) {
+		if (count < LOCAL) local[count] = value;
+		else overflow.push_back(value);
+		count++;
+	}
+
+	T pop() {
+		count--;
+		if (count >= LOCAL) {
+			auto value = overflow.back();
+			overflow.pop_back();
+			return value;
+		}
+		return local[count];
+	}
+
+	bool empty() const { return count == 0; }
+private:
+	static constexpr uint32_t LOCAL = 64;
+
+	T local[LOCAL];
+	uint32_t count{ 0 };
+	std::vector<T> overflow;
+};
+
+struct RayEntry {
+	uint32_t node;
+	float distance;
+};
+
+// frustum 평면 : |normal|을 미리 구해둔다
+struct FrustumPlanes {
+	float nx[6], ny[6], nz[6], w[6];
+	float ax[6], ay[6], az[6];
+
+	FrustumPlanes(const VEfrustum& frustum) {
+		for (int p = 0; p < 6; p++) {
+			auto& plane = frustum.planes[p];
+			nx[p] = plane.x;
+			ny[p] = plane.y;
+			nz[p] = plane.z;
+			w[p] = plane.w;
+			ax[p] = std::abs(plane.x);
+			ay[p] = std::abs(plane.y);
+			az[p] = std::abs(plane.z);
+		}
+	}
+};
+
+inline uint32_t lowestBit(uint32_t mask) {
+	uint32_t slot = 0;
+	while (!(mask & (1u << slot))) slot++;
+	return slot;
+}
+
+#if defined(VE_BVH_SSE)
+
+inline uint32_t overlapBox(const VEbvhNode& node, const VEaabb& box) {
+	auto inside = _mm_and_ps(
+		_mm_and_ps(
+			_mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minX), _mm_set1_ps(box.max.x)), _mm_cmpge_ps(_mm_load_ps(node.maxX), _mm_set1_ps(box.min.x))),
+			_mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minY), _mm_set1_ps(box.max.y)), _mm_cmpge_ps(_mm_load_ps(node.maxY), _mm_set1_ps(box.min.y)))),
+		_mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minZ), _mm_set1_ps(box.max.z)), _mm_cmpge_ps(_mm_load_ps(node.maxZ), _mm_set1_ps(box.min.z))));
+	return static_cast<uint32_t>(_mm_movemask_ps(inside));
+}
+
+inline uint32_t overlapSphere(const VEbvhNode& node, const glm::vec3& center, float radius) {
+	auto zero = _mm_setzero_ps();
+	auto axisDistance = [&](const float* min, const float* max, float c) {
+		auto value = _mm_set1_ps(c);
+		// box 밖으로 나간 거리 (안쪽이면 0)
+		return _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(min), value), _mm_sub_ps(value, _mm_load_ps(max))), zero);
+	};
+
+	auto dx = axisDistance(node.minX, node.maxX, center.x);
+	auto dy = axisDistance(node.minY, node.maxY, center.y);
+	auto dz = axisDistance(node.minZ, node.maxZ, center.z);
+	auto distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+	// 빈 slot은 min > max라 거리가 무한대가 되지만 occupied mask로 한 번 더 거른다
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(distance2, _mm_set1_ps(radius * radius))));
+}
+
+// outside : 어떤 평면의 완전히 바깥, inside : 모든 평면의 완전히 안쪽
+inline void testFrustum(const VEbvhNode& node, const FrustumPlanes& planes, uint32_t& outside, uint32_t& inside) {
+	auto half = _mm_set1_ps(0.5f);
+	auto minX = _mm_load_ps(node.minX), maxX = _mm_load_ps(node.maxX);
+	auto minY = _mm_load_ps(node.minY), maxY = _mm_load_ps(node.maxY);
+	auto minZ = _mm_load_ps(node.minZ), maxZ = _mm_load_ps(node.maxZ);
+
+	// VEboxBounds와 같은 center / extent
+	auto cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half), ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+	auto cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half), ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+	auto cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half), ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+	auto zero = _mm_setzero_ps();
+	auto out = zero;
+	auto in = _mm_cmpeq_ps(zero, zero);
+	for (int p = 0; p < 6; p++) {
+		auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(planes.nx[p]), cx), _mm_mul_ps(_mm_set1_ps(planes.ny[p]), cy)),
+			_mm_mul_ps(_mm_set1_ps(planes.nz[p]), cz)), _mm_set1_ps(planes.w[p]));
+		auto reach = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(planes.ax[p]), ex), _mm_mul_ps(_mm_set1_ps(planes.ay[p]), ey)),
+			_mm_mul_ps(_mm_set1_ps(planes.az[p]), ez));
+
+		out = _mm_or_ps(out, _mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+		in = _mm_and_ps(in, _mm_cmpge_ps(_mm_sub_ps(distance, reach), zero));
+	}
+
+	outside = static_cast<uint32_t>(_mm_movemask_ps(out));
+	inside = static_cast<uint32_t>(_mm_movemask_ps(in));
+}
+
+// slab test : 닿는 slot의 bit와 AABB에 들어가는 거리
+inline uint32_t intersectRay(const VEbvhNode& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance,
+	float* entry) {
+	auto slab = [&](const float* min, const float* max, float o, float inverse, __m128& near, __m128& far) {
+		auto value = _mm_set1_ps(o);
+		auto scale = _mm_set1_ps(inverse);
+		auto t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min), value), scale);
+		auto t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max), value), scale);
+		near = _mm_max_ps(near, _mm_min_ps(t0, t1));
+		far = _mm_min_ps(far, _mm_max_ps(t0, t1));
+	};
+
+	auto near = _mm_setzero_ps();
+	auto far = _mm_set1_ps(maxDistance);
+	slab(node.minX, node.maxX, origin.x, inverseDirection.x, near, far);
+	slab(node.minY, node.maxY, origin.y, inverseDirection.y, near, far);
+	slab(node.minZ, node.maxZ, origin.z, inverseDirection.z, near, far);
+
+	_mm_storeu_ps(entry, near);
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(near, far)));
+}
+
+#else
+
+inline uint32_t overlapBox(const VEbvhNode& node, const VEaabb& box) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		bool hit = node.minX[i] <= box.max.x && node.maxX[i] >= box.min.x &&
+			node.minY[i] <= box.max.y && node.maxY[i] >= box.min.y &&
+			node.minZ[i] <= box.max.z && node.maxZ[i] >= box.min.z;
+		mask |= static_cast<uint32_t>(hit) << i;
+	}
+	return mask;
+}
+
+inline uint32_t overlapSphere(const VEbvhNode& node, const glm::vec3& center, float radius) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		auto dx = std::max(std::max(node.minX[i] - center.x, center.x - node.maxX[i]), 0.0f);
+		auto dy = std::max(std::max(node.minY[i] - center.y, center.y - node.maxY[i]), 0.0f);
+		auto dz = std::max(std::max(node.minZ[i] - center.z, center.z - node.maxZ[i]), 0.0f);
+		mask |= static_cast<uint32_t>(dx * dx + dy * dy + dz * dz <= radius * radius) << i;
+	}
+	return mask;
+}
+
+inline void testFrustum(const VEbvhNode& node, const FrustumPlanes& planes, uint32_t& outside, uint32_t& inside) {
+	outside = 0;
+	inside = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		float cx = (node.minX[i] + node.maxX[i]) * 0.5f, ex = (node.maxX[i] - node.minX[i]) * 0.5f;
+		float cy = (node.minY[i] + node.maxY[i]) * 0.5f, ey = (node.maxY[i] - node.minY[i]) * 0.5f;
+		float cz = (node.minZ[i] + node.maxZ[i]) * 0.5f, ez = (node.maxZ[i] - node.minZ[i]) * 0.5f;
+
+		bool out = false, in = true;
+		for (int p = 0; p < 6; p++) {
+			auto distance = planes.nx[p] * cx + planes.ny[p] * cy + planes.nz[p] * cz + planes.w[p];
+			auto reach = planes.ax[p] * ex + planes.ay[p] * ey + planes.az[p] * ez;
+			out |= distance + reach < 0.0f;
+			in &= distance - reach >= 0.0f;
+		}
+		outside |= static_cast<uint32_t>(out) << i;
+		inside |= static_cast<uint32_t>(in) << i;
+	}
+}
+
+inline uint32_t intersectRay(const VEbvhNode& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance,
+	float* entry) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		float near = 0.0f, far = maxDistance;
+		auto slab = [&](float min, float max, float o, float inverse) {
+			auto t0 = (min - o) * inverse;
+			auto t1 = (max - o) * inverse;
+			near = std::max(near, std::min(t0, t1));
+			far = std::min(far, std::max(t0, t1));
+		};
+		slab(node.minX[i], node.maxX[i], origin.x, inverseDirection.x);
+		slab(node.minY[i], node.maxY[i], origin.y, inverseDirection.y);
+		slab(node.minZ[i], node.maxZ[i], origin.z, inverseDirection.z);
+
+		entry[i] = near;
+		mask |= static_cast<uint32_t>(near <= far) << i;
+	}
+	return mask;
+}
+
+#endif
+
+}
+
+// ---- Build ----
+
+void VEbvh::clear() {
+	nodes.clear();
+	freeNodes.clear();
+	root = INVALID;
+	locations.clear();
+	freeObjects.clear();
+	objectCount = 0;
+}
+
+void VEbvh::build(const std::vector<VEaabb>& bounds) {
+	clear();
+
+	auto count = static_cast<uint32_t>(bounds.size());
+	locations.resize(count);
+	objectCount = count;
+
+	std::vector<BuildItem> items(count);
+	for (uint32_t i = 0; i < count; i++) {
+		items[i] = BuildItem{
+			.bounds = bounds[i],
+			.centroid = (bounds[i].min + bounds[i].max) * 0.5f,
+			.object = i,
+		};
+	}
+
+	buildItems(items);
+}
+
+void VEbvh::rebuild() {
+	std::vector<BuildItem> items;
+	items.reserve(objectCount);
+
+	for (uint32_t object = 0; object < locations.size(); object++) {
+		if (!isValid(object)) continue;
+
+		auto bounds = getBounds(object);
+		items.push_back(BuildItem{
+			.bounds = bounds,
+			.centroid = (bounds.min + bounds.max) * 0.5f,
+			.object = object,
+		});
+	}
+
+	nodes.clear();
+	freeNodes.clear();
+	root = INVALID;
+
+	buildItems(items);
+}
+
+void VEbvh::buildItems(std::vector<BuildItem>& items) {
+	// object가 하나도 없어도 root는 둔다 (insert가 채운다)
+	nodes.reserve(items.size() / 2 + 1);
+
+	if (items.empty()) {
+		root = allocateNode(INVALID, 0);
+		return;
+	}
+
+	root = buildNode(items, 0, static_cast<uint32_t>(items.size()), INVALID, 0);
+}
+
+// [begin, end)를 SAH로 나눠가며 자식 4개를 채운다 (object가 가장 많은 range부터 나눈다)
+uint32_t VEbvh::buildNode(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t parent, uint32_t parentSlot) {
+	auto node = allocateNode(parent, parentSlot);
+
+	struct Range {
+		uint32_t begin, end;
+	};
+
+	Range ranges[4]{ { begin, end } };
+	uint32_t rangeCount = 1;
+
+	while (rangeCount < 4) {
+		uint32_t largest = INVALID;
+		uint32_t largestCount = 1;
+		for (uint32_t i = 0; i < rangeCount; i++) {
+			auto count = ranges[i].end - ranges[i].begin;
+			if (count > largestCount) {
+				largest = i;
+				largestCount = count;
+			}
+		}
+
+		// 모든 range가 object 하나
+		if (largest == INVALID) break;
+
+		auto middle = splitSAH(items, ranges[largest].begin, ranges[largest].end);
+		ranges[rangeCount++] = { middle, ranges[largest].end };
+		ranges[largest].end = middle;
+	}
+
+	for (uint32_t slot = 0; slot < rangeCount; slot++) {
+		auto& range = ranges[slot];
+
+		if (range.end - range.begin == 1) {
+			auto& item = items[range.begin];
+			setChild(node, slot, LEAF | item.object, item.bounds);
+		}
+		else {
+			// buildNode가 nodes를 늘리므로 참조를 들고 있으면 안 된다
+			auto child = buildNode(items, range.begin, range.end, node, slot);
+			setChild(node, slot, child, nodes[child].getBounds());
+		}
+	}
+
+	return node;
+}
+
+// 축 마다 centroid를 SAH_BINS개로 나눠 (left 면적 x 개수 + right 면적 x 개수)가 가장 작은 곳에서 나눈다
+// 세 축의 bin은 item을 한 번 읽으며 같이 채운다
+uint32_t VEbvh::splitSAH(std::vector<BuildItem>& items, uint32_t begin, uint32_t end) const {
+	VEaabb centroidBounds;
+	for (auto i = begin; i < end; i++) {
+		centroidBounds.expand(items[i].centroid);
+	}
+
+	struct Bin {
+		VEaabb bounds;
+		uint32_t count{ 0 };
+	};
+
+	// 작은 range는 bin을 줄인다 (아래쪽 node가 대부분이라 bin 초기화와 sweep 비용이 커진다)
+	auto binCount = std::min(SAH_BINS, end - begin);
+
+	// centroid -> bin 번호 (축 길이가 0이면 모두 0번 bin)
+	auto extent = centroidBounds.max - centroidBounds.min;
+	glm::vec3 scale;
+	for (int axis = 0; axis < 3; axis++) {
+		scale[axis] = extent[axis] > 0.0f ? binCount / extent[axis] : 0.0f;
+	}
+
+	auto binIndex = [&](const glm::vec3& centroid, int axis) {
+		auto bin = static_cast<uint32_t>((centroid[axis] - centroidBounds.min[axis]) * scale[axis]);
+		return std::min(bin, binCount - 1);
+	};
+
+	Bin bins[3][SAH_BINS];
+	for (auto i = begin; i < end; i++) {
+		auto& item = items[i];
+		for (int axis = 0; axis < 3; axis++) {
+			auto& bin = bins[axis][binIndex(item.centroid, axis)];
+			bin.bounds.expand(item.bounds);
+			bin.count++;
+		}
+	}
+
+	float bestCost = std::numeric_limits<float>::max();
+	int bestAxis = -1;
+	uint32_t bestBin = 0;
+
+	for (int axis = 0; axis < 3; axis++) {
+		if (extent[axis] <= 0.0f) continue;
+
+		// 오른쪽부터 누적
+		float rightArea[SAH_BINS]{};
+		uint32_t rightCount[SAH_BINS]{};
+		VEaabb accumulated;
+		uint32_t count = 0;
+		for (auto bin = binCount - 1; bin > 0; bin--) {
+			accumulated.expand(bins[axis][bin].bounds);
+			count += bins[axis][bin].count;
+			rightArea[bin] = accumulated.surfaceArea();
+			rightCount[bin] = count;
+		}
+
+		accumulated = {};
+		count = 0;
+		for (uint32_t bin = 0; bin + 1 < binCount; bin++) {
+			accumulated.expand(bins[axis][bin].bounds);
+			count += bins[axis][bin].count;
+
+			if (count == 0 || rightCount[bin + 1] == 0) continue;
+
+			auto cost = accumulated.surfaceArea() * count + rightArea[bin + 1] * rightCount[bin + 1];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = bin + 1;
+			}
+		}
+	}
+
+	// centroid가 모두 같으면 반으로 나눈다
+	if (bestAxis < 0) {
+		return begin + (end - begin) / 2;
+	}
+
+	auto middle = std::partition(items.begin() + begin, items.begin() + end, [&](const BuildItem& item) {
+		return binIndex(item.centroid, bestAxis) < bestBin;
+	});
+
+	return static_cast<uint32_t>(middle - items.begin());
+}
+
+// ---- Node / object 관리 ----
+
+uint32_t VEbvh::allocateNode(uint32_t parent, uint32_t parentSlot) {
+	uint32_t node;
+	if (!freeNodes.empty()) {
+		node = freeNodes.back();
+		freeNodes.pop_back();
+	}
+	else {
+		node = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+	}
+
+	auto& n = nodes[node];
+	for (uint32_t slot = 0; slot < 4; slot++) {
+		n.children[slot] = EMPTY;
+		n.setChildBounds(slot, VEaabb{});
+	}
+	n.parent = parent;
+	n.parentSlot = parentSlot;
+
+	return node;
+}
+
+void VEbvh::freeNode(uint32_t node) {
+	freeNodes.push_back(node);
+}
+
+void VEbvh::setChild(uint32_t node, uint32_t slot, uint32_t child, const VEaabb& bounds) {
+	nodes[node].children[slot] = child;
+	nodes[node].setChildBounds(slot, bounds);
+
+	if (child & LEAF) {
+		locations[child & ~LEAF] = Location{ .node = node, .slot = slot };
+	}
+	else {
+		nodes[child].parent = node;
+		nodes[child].parentSlot = slot;
+	}
+}
+
+void VEbvh::clearChild(uint32_t node, uint32_t slot) {
+	nodes[node].children[slot] = EMPTY;
+	nodes[node].setChildBounds(slot, VEaabb{});
+}
+
+VEaabb VEbvh::getBounds(uint32_t object) const {
+	auto& location = locations[object];
+	return nodes[location.node].getChildBounds(location.slot);
+}
+
+// ---- Insert / Remove ----
+
+uint32_t VEbvh::insert(const VEaabb& bounds) {
+	uint32_t object;
+	if (!freeObjects.empty()) {
+		object = freeObjects.back();
+		freeObjects.pop_back();
+	}
+	else {
+		object = static_cast<uint32_t>(locations.size());
+		locations.emplace_back();
+	}
+
+	if (root == INVALID) {
+		root = allocateNode(INVALID, 0);
+	}
+
+	insertLeaf(object, bounds);
+	objectCount++;
+	return object;
+}
+
+// 빈 slot이 있으면 넣고, 없으면 면적 증가가 가장 작은 자식으로 내려간다 (내려가며 bound를 늘린다)
+// 고른 자식이 object면 그 object와 새 object를 담는 node를 만들어 그 자리에 둔다
+void VEbvh::insertLeaf(uint32_t object, const VEaabb& bounds) {
+	auto node = root;
+
+	while (true) {
+		auto occupied = nodes[node].getOccupiedMask();
+		if (occupied != 0xF) {
+			setChild(node, lowestBit(~occupied & 0xF), LEAF | object, bounds);
+			return;
+		}
+
+		uint32_t best = 0;
+		float bestGrowth = std::numeric_limits<float>::max();
+		float bestArea = std::numeric_limits<float>::max();
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			auto childBounds = nodes[node].getChildBounds(slot);
+			auto area = childBounds.surfaceArea();
+			childBounds.expand(bounds);
+			auto growth = childBounds.surfaceArea() - area;
+
+			if (growth < bestGrowth || (growth == bestGrowth && area < bestArea)) {
+				best = slot;
+				bestGrowth = growth;
+				bestArea = area;
+			}
+		}
+
+		auto child = nodes[node].children[best];
+		auto childBounds = nodes[node].getChildBounds(best);
+		auto merged = childBounds;
+		merged.expand(bounds);
+
+		if (child & LEAF) {
+			auto split = allocateNode(node, best);
+			setChild(split, 0, child, childBounds);
+			setChild(split, 1, LEAF | object, bounds);
+			setChild(node, best, split, merged);
+			return;
+		}
+
+		nodes[node].setChildBounds(best, merged);
+		node = child;
+	}
+}
+
+void VEbvh::remove(uint32_t object) {
+	if (!isValid(object)) return;
+
+	auto location = locations[object];
+	clearChild(location.node, location.slot);
+	locations[object] = Location{};
+	freeObjects.push_back(object);
+	objectCount--;
+
+	// 빈 node는 부모에서 떼어낸다
+	auto node = location.node;
+	while (node != root && nodes[node].getOccupiedMask() == 0) {
+		auto parent = nodes[node].parent;
+		clearChild(parent, nodes[node].parentSlot);
+		freeNode(node);
+		node = parent;
+	}
+
+	// 자식이 하나만 남은 node는 그 자식을 부모 slot으로 올린다 (depth를 늘리지 않도록)
+	auto occupied = nodes[node].getOccupiedMask();
+	if (node != root && (occupied & (occupied - 1)) == 0) {
+		auto slot = lowestBit(occupied);
+		auto parent = nodes[node].parent;
+		setChild(parent, nodes[node].parentSlot, nodes[node].children[slot], nodes[node].getChildBounds(slot));
+		freeNode(node);
+		node = parent;
+	}
+
+	refitUpward(node);
+}
+
+// ---- Refit ----
+
+void VEbvh::update(uint32_t object, const VEaabb& bounds) {
+	setBounds(object, bounds);
+	refitUpward(locations[object].node);
+}
+
+void VEbvh::setBounds(uint32_t object, const VEaabb& bounds) {
+	auto& location = locations[object];
+	nodes[location.node].setChildBounds(location.slot, bounds);
+}
+
+// node의 bound가 부모 slot과 같아질 때까지 root 쪽으로 고친다
+void VEbvh::refitUpward(uint32_t node) {
+	while (node != root) {
+		auto parent = nodes[node].parent;
+		auto slot = nodes[node].parentSlot;
+		auto bounds = nodes[node].getBounds();
+
+		if (nodes[parent].getChildBounds(slot) == bounds) break;
+
+		nodes[parent].setChildBounds(slot, bounds);
+		node = parent;
+	}
+}
+
+void VEbvh::refit() {
+	if (root != INVALID) {
+		refitNode(root);
+	}
+}
+
+// 자식 node부터 고치고 (post order) 자기 bound를 돌려준다
+VEaabb VEbvh::refitNode(uint32_t node) {
+	for (uint32_t slot = 0; slot < 4; slot++) {
+		auto child = nodes[node].children[slot];
+		if (child == EMPTY || (child & LEAF)) continue;
+
+		nodes[node].setChildBounds(slot, refitNode(child));
+	}
+
+	return nodes[node].getBounds();
+}
+
+// ---- Query ----
+
+void VEbvh::collectAll(uint32_t node, std::vector<uint32_t>& out) const {
+	TraversalStack<uint32_t> stack;
+	stack.push(node);
+
+	while (!stack.empty()) {
+		auto& n = nodes[stack.pop()];
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			auto child = n.children[slot];
+			if (child == EMPTY) continue;
+
+			if (child & LEAF) out.push_back(child & ~LEAF);
+			else stack.push(child);
+		}
+	}
+}
+
+void VEbvh::queryFrustum(const VEfrustum& frustum, std::vector<uint32_t>& out) const {
+	if (root == INVALID) return;
+
+	FrustumPlanes planes(frustum);
+	TraversalStack<uint32_t> stack;
+	stack.push(root);
+
+	while (!stack.empty()) {
+		auto& node = nodes[stack.pop()];
+
+		uint32_t outside, inside;
+		testFrustum(node, planes, outside, inside);
+
+		auto mask = node.getOccupiedMask() & ~outside;
+		while (mask) {
+			auto slot = lowestBit(mask);
+			mask &= mask - 1;
+
+			auto child = node.children[slot];
+			if (child & LEAF) out.push_back(child & ~LEAF);
+			else if (inside & (1u << slot)) collectAll(child, out);	// 완전히 안 : 더 검사하지 않는다
+			else stack.push(child);
+		}
+	}
+}
+
+void VEbvh::queryBox(const VEaabb& box, std::vector<uint32_t>& out) const {
+	if (root == INVALID) return;
+
+	TraversalStack<uint32_t> stack;
+	stack.push(root);
+
+	while (!stack.empty()) {
+		auto& node = nodes[stack.pop()];
+
+		auto mask = node.getOccupiedMask() & overlapBox(node, box);
+		while (mask) {
+			auto slot = lowestBit(mask);
+			mask &= mask - 1;
+
+			auto child = node.children[slot];
+			if (child & LEAF) out.push_back(child & ~LEAF);
+			else stack.push(child);
+		}
+	}
+}
+
+void VEbvh::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const {
+	if (root == INVALID) return;
+
+	TraversalStack<uint32_t> stack;
+	stack.push(root);
+
+	while (!stack.empty()) {
+		auto& node = nodes[stack.pop()];
+
+		auto mask = node.getOccupiedMask() & overlapSphere(node, center, radius);
+		while (mask) {
+			auto slot = lowestBit(mask);
+			mask &= mask - 1;
+
+			auto child = node.children[slot];
+			if (child & LEAF) out.push_back(child & ~LEAF);
+			else stack.push(child);
+		}
+	}
+}
+
+// 가까운 자식부터 내려가고, 지금까지 찾은 hit보다 먼 node는 건너뛴다
+VEbvhHit VEbvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const IntersectFunc& intersect) const {
+	VEbvhHit hit{ .distance = maxDistance };
+	if (root == INVALID) return hit;
+
+	// 0 방향 성분은 아주 작은 값으로 바꿔 (0 x inf) NaN을 피한다
+	glm::vec3 inverseDirection;
+	for (int axis = 0; axis < 3; axis++) {
+		auto d = direction[axis];
+		if (std::abs(d) < 1e-20f) d = std::copysign(1e-20f, d);
+		inverseDirection[axis] = 1.0f / d;
+	}
+
+	TraversalStack<RayEntry> stack;
+	stack.push(RayEntry{ root, 0.0f });
+
+	while (!stack.empty()) {
+		auto entry = stack.pop();
+		if (entry.distance > hit.distance) continue;
+
+		auto& node = nodes[entry.node];
+
+		float distances[4];
+		auto mask = node.getOccupiedMask() & intersectRay(node, origin, inverseDirection, hit.distance, distances);
+
+		RayEntry inner[4];
+		uint32_t innerCount = 0;
+
+		while (mask) {
+			auto slot = lowestBit(mask);
+			mask &= mask - 1;
+
+			auto child = node.children[slot];
+			if (child & LEAF) {
+				auto object = child & ~LEAF;
+				auto distance = intersect ? intersect(object, distances[slot]) : distances[slot];
+				if (distance >= 0.0f && distance < hit.distance) {
+					hit = VEbvhHit{ .object = object, .distance = distance };
+				}
+			}
+			else {
+				inner[innerCount++] = RayEntry{ child, distances[slot] };
+			}
+		}
+
+		// 먼 것부터 넣어 가까운 것이 먼저 나오게 한다
+		std::sort(inner, inner + innerCount, [](const RayEntry& a, const RayEntry& b) { return a.distance > b.distance; });
+		for (uint32_t i = 0; i < innerCount; i++) {
+			stack.push(inner[i]);
+		}
+	}
+
+	return hit;
+}
+
+// ---- Stats ----
+
+uint32_t VEbvh::getDepth() const {
+	if (root == INVALID) return 0;
+
+	uint32_t depth = 0;
+	TraversalStack<std::pair<uint32_t, uint32_t>> stack;
+	stack.push({ root, 1 });
+
+	while (!stack.empty()) {
+		auto [node, level] = stack.pop();
+		depth = std::max(depth, level);
+
+		for (auto child : nodes[node].children) {
+			if (child != EMPTY && !(child & LEAF)) stack.push({ child, level + 1 });
+		}
+	}
+
+	return depth;
+}
+
+float VEbvh::getSAHCost() const {
+	if (root == INVALID) return 0.0f;
+
+	auto rootArea = nodes[root].getBounds().surfaceArea();
+	if (rootArea <= 0.0f) return 0.0f;
+
+	// node를 순회하면 자식 4개를 검사하고, object slot은 한 번씩 검사한다
+	double cost = 0.0;
+	TraversalStack<uint32_t> stack;
+	stack.push(root);
+
+	while (!stack.empty()) {
+		auto& node = nodes[stack.pop()];
+		cost += node.getBounds().surfaceArea();
+
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			auto child = node.children[slot];
+			if (child == EMPTY) continue;
+
+			if (child & LEAF) cost += node.getChildBounds(slot).surfaceArea();
+			else stack.push(child);
+		}
+	}
+
+	return static_cast<float>(cost / rootArea);
+}
+
+void VEbvh::printStats(std::ostream& out) const {
+	out << "bvh: " << objectCount << " objects, " << getNodeCount() << " nodes (" << getNodeCount() * sizeof(VEbvhNode) / 1024
+		<< " KB), depth " << getDepth() << ", SAH cost " << getSAHCost() << "\n";
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "VEculling.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+// ------------- Bounding Volume Hierarchy ----------------
+//
+// scene object의 AABB로 만든 4갈래 BVH (BVH4). frustum / ray / sphere / AABB query를 object 수의 log 정도로 한다.
+// node 하나에 자식 4개의 AABB를 SoA로 두어 (128 byte, cache line 2개) SSE 한 번에 4개를 비교한다.
+// 자식 slot은 비어 있거나, 다른 node이거나, object 하나 (leaf)이다.
+//	- build(bounds)			: binned SAH로 한 번에 만든다 (range를 SAH로 나눠가며 node의 자식 4개를 채운다)
+//	- insert / remove		: 다시 만들지 않고 끼워 넣거나 뺀다 (insert는 면적 증가가 가장 작은 자식을 따라 내려간다)
+//	- update(id, bounds)	: 움직인 object의 leaf부터 root 쪽으로 bound를 고친다 (바뀌지 않으면 멈춘다)
+//	- setBounds + refit		: 많은 object가 움직인 frame은 bound만 바꿔두고 한 번에 아래에서부터 고친다
+// insert / update가 쌓이면 tree 품질 (getSAHCost)이 떨어지므로 가끔 rebuild() 한다.
+//
+// 순회는 고정 크기 stack을 쓴다 (넘치면 heap으로 이어간다).
+// frustum query는 완전히 안에 들어온 node 아래를 평면 검사 없이 모두 넣는다.
+// leaf 판정은 VEfrustum::testBox와 같은 식이라 VEculler (VEboxBounds)와 결과가 같다.
+
+struct VEaabb {
+	glm::vec3 min{ std::numeric_limits<float>::max() };
+	glm::vec3 max{ std::numeric_limits<float>::lowest() };
+
+	bool isEmpty() const { return min.x > max.x; }
+	void expand(const VEaabb& other);
+	void expand(const glm::vec3& point);
+	float surfaceArea() const;	// 비어 있으면 0
+
+	bool operator==(const VEaabb& other) const { return min == other.min && max == other.max; }
+};
+
+struct alignas(64) VEbvhNode {
+	// 자식 4개의 AABB (빈 slot은 min > max)
+	float minX[4], minY[4], minZ[4];
+	float maxX[4], maxY[4], maxZ[4];
+	uint32_t children[4];	// EMPTY / node 번호 / LEAF | object id
+	uint32_t parent;		// root는 INVALID
+	uint32_t parentSlot;
+
+	VEaabb getChildBounds(uint32_t slot) const;
+	void setChildBounds(uint32_t slot, const VEaabb& bounds);
+	VEaabb getBounds() const;	// 자식 전체
+	uint32_t getOccupiedMask() const;
+};
+
+struct VEbvhHit {
+	uint32_t object{ ~0u };
+	float distance{ std::numeric_limits<float>::max() };
+};
+
+class VEbvh {
+public:
+	static constexpr uint32_t INVALID = ~0u;
+	static constexpr uint32_t EMPTY = ~0u;
+	static constexpr uint32_t LEAF = 0x80000000u;
+
+	// object id = bounds의 번호 (기존 내용은 지운다)
+	void build(const std::vector<VEaabb>& bounds);
+	// 지금 object들로 다시 만든다 (id는 그대로)
+	void rebuild();
+	void clear();
+
+	uint32_t insert(const VEaabb& bounds);
+	void remove(uint32_t object);
+	void update(uint32_t object, const VEaabb& bounds);
+	// bound만 바꾼다 (refit 전까지 위쪽 node는 예전 bound)
+	void setBounds(uint32_t object, const VEaabb& bounds);
+	void refit();
+
+	// 결과는 out 뒤에 추가한다 (순서는 정해져 있지 않다)
+	void queryFrustum(const VEfrustum& frustum, std::vector<uint32_t>& out) const;
+	void queryBox(const VEaabb& box, std::vector<uint32_t>& out) const;
+	void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+	// 가장 가까운 hit (없으면 object == INVALID)
+	// intersect : AABB에 닿은 object와의 정확한 거리 (안 닿으면 음수), 없으면 AABB까지의 거리를 쓴다
+	using IntersectFunc = std::function<float(uint32_t object, float aabbDistance)>;
+	VEbvhHit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = std::numeric_limits<float>::max(),
+		const IntersectFunc& intersect = nullptr) const;
+
+	bool isValid(uint32_t object) const { return object < locations.size() && locations[object].node != INVALID; }
+	VEaabb getBounds(uint32_t object) const;
+	uint32_t getObjectCount() const { return objectCount; }
+	uint32_t getNodeCount() const { return static_cast<uint32_t>(nodes.size() - freeNodes.size()); }
+	uint32_t getDepth() const;
+	// node 순회 비용 1, object 검사 비용 1 기준의 SAH cost (root 면적으로 나눈 값)
+	float getSAHCost() const;
+
+	void printStats(std::ostream& out) const;
+private:
+	struct Location {
+		uint32_t node{ INVALID };
+		uint32_t slot{ 0 };
+	};
+
+	struct BuildItem {
+		VEaabb bounds;
+		glm::vec3 centroid;
+		uint32_t object;
+	};
+
+	std::vector<VEbvhNode> nodes;
+	std::vector<uint32_t> freeNodes;
+	uint32_t root{ INVALID };
+
+	std::vector<Location> locations;	// object id -> leaf가 있는 slot (node INVALID = 쓰지 않는 id)
+	std::vector<uint32_t> freeObjects;
+	uint32_t objectCount{ 0 };
+
+	uint32_t allocateNode(uint32_t parent, uint32_t parentSlot);
+	void freeNode(uint32_t node);
+	// slot에 child (node 또는 LEAF | object)를 두고 child 쪽 역참조 (parent, location)를 맞춘다
+	void setChild(uint32_t node, uint32_t slot, uint32_t child, const VEaabb& bounds);
+	void clearChild(uint32_t node, uint32_t slot);
+	void refitUpward(uint32_t node);
+	VEaabb refitNode(uint32_t node);
+
+	uint32_t buildNode(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t parent, uint32_t parentSlot);
+	uint32_t splitSAH(std::vector<BuildItem>& items, uint32_t begin, uint32_t end) const;
+	void buildItems(std::vector<BuildItem>& items);
+	void insertLeaf(uint32_t object, const VEaabb& bounds);
+
+	void collectAll(uint32_t node, std::vector<uint32_t>& out) const;
+};
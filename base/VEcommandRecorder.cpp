@@ -0,0 +1,118 @@
+#include "VEcommandRecorder.h"
+#include "VEprofiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+void VEcommandRecorder::init(vk::Device device, uint32_t queueFamily, uint32_t framesInFlight, VEjobSystem& jobs) {
+	this->device = device;
+	this->jobs = &jobs;
+
+	vk::CommandPoolCreateInfo poolInfo{
+		.flags = vk::CommandPoolCreateFlagBits::eTransient,	// 매 frame pool 단위로 reset
+		.queueFamilyIndex = queueFamily,
+	};
+
+	frames.resize(framesInFlight);
+	for (auto& frame : frames) {
+		frame.primaryPool = device.createCommandPool(poolInfo);
+
+		vk::CommandBufferAllocateInfo allocInfo{
+			.commandPool = frame.primaryPool,
+			.level = vk::CommandBufferLevel::ePrimary,
+			.commandBufferCount = 1,
+		};
+		frame.primary = device.allocateCommandBuffers(allocInfo).front();
+
+		// attach 된 thread 몫까지
+		frame.threads.resize(jobs.getThreadCount());
+		for (auto& thread : frame.threads) {
+			thread.pool = device.createCommandPool(poolInfo);
+		}
+	}
+}
+
+void VEcommandRecorder::cleanUp() {
+	// pool을 파괴하면 할당된 command buffer도 함께 해제된다
+	for (auto& frame : frames) {
+		for (auto& thread : frame.threads) {
+			device.destroyCommandPool(thread.pool);
+		}
+		device.destroyCommandPool(frame.primaryPool);
+	}
+	frames.clear();
+	current = nullptr;
+}
+
+vk::CommandBuffer VEcommandRecorder::beginFrame(uint32_t frameIndex) {
+	current = &frames[frameIndex % frames.size()];
+
+	device.resetCommandPool(current->primaryPool);
+	for (auto& thread : current->threads) {
+		if (thread.used == 0) continue;
+
+		device.resetCommandPool(thread.pool);
+		thread.used = 0;
+	}
+
+	return current->primary;
+}
+
+vk::CommandBuffer VEcommandRecorder::acquireSecondary(ThreadPool& thread) {
+	if (thread.used == thread.secondaries.size()) {
+		vk::CommandBufferAllocateInfo allocInfo{
+			.commandPool = thread.pool,
+			.level = vk::CommandBufferLevel::eSecondary,
+			.commandBufferCount = 1,
+		};
+		thread.secondaries.push_back(device.allocateCommandBuffers(allocInfo).front());
+	}
+
+	return thread.secondaries[thread.used++];
+}
+
+void VEcommandRecorder::recordParallel(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance,
+	uint32_t drawCount, const RecordRange& record, uint32_t minPerThread) {
+	VE_PROFILE_FUNCTION();
+
+	if (drawCount == 0) return;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// thread 수 만큼 나눈다 (한 조각이 minPerThread보다 작아지지 않도록)
+	uint32_t count = std::min(getThreadCount(), std::max(1u, drawCount / std::max(1u, minPerThread)));
+	uint32_t perChunk = (drawCount + count - 1) / count;
+
+	std::vector<vk::CommandBuffer> secondaries((drawCount + perChunk - 1) / perChunk);
+
+	jobs->parallelFor(drawCount, perChunk, [&](uint32_t first, uint32_t size) {
+		VE_PROFILE_ZONE("recordSecondary");
+
+		// job을 실행하는 thread의 pool을 쓴다 (한 thread는 한번에 job 하나만 실행한다)
+		auto thread = VEjobSystem::threadIndex();
+		auto commandBuffer = acquireSecondary(current->threads[thread]);
+
+		vk::CommandBufferBeginInfo beginInfo{
+			.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+			.pInheritanceInfo = &inheritance,
+		};
+		commandBuffer.begin(beginInfo);
+		record(commandBuffer, thread, first, size);
+		commandBuffer.end();
+
+		secondaries[first / perChunk] = commandBuffer;
+	});
+
+	primary.executeCommands(secondaries);
+
+	lastRecordMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	totalRecordMs += lastRecordMs;
+	recordCount++;
+}
+
+void VEcommandRecorder::printStats(std::ostream& out) const {
+	if (recordCount == 0) return;
+
+	out << "command recorder: " << getThreadCount() << " threads, " << totalRecordMs / recordCount << " ms / parallel record ("
+		<< recordCount << " records)\n";
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include "VEjobSystem.h"
+
+#include <functional>
+#include <ostream>
+#include <vector>
+
+// ------------- Command Recorder ----------------
+//
+// frame in flight 마다, job system thread 마다 command pool을 따로 둔다 (pool은 한 thread만 사용해야 한다).
+//	- beginFrame(frame)		: 그 slot의 pool을 모두 reset 하고 (command buffer 개별 reset 대신) primary를 돌려준다
+//	- recordParallel(...)	: renderpass 안의 draw를 thread 수로 나눠 secondary command buffer에 기록한 뒤
+//							  primary에서 executeCommands 한다
+// secondary는 pool reset 후 다시 쓰므로 frame 마다 새로 할당하지 않는다.
+//
+// 나눈 범위는 job system의 job으로 실행되며, 호출한 thread도 기다리는 동안 job을 실행한다.
+// 따라서 recordParallel은 job system에 등록된 thread (main 또는 attachThread)에서 호출해야 한다.
+// renderpass는 vk::SubpassContents::eSecondaryCommandBuffers로 시작해야 하며,
+// viewport / scissor 같은 dynamic state는 secondary 마다 다시 설정해야 한다.
+
+class VEcommandRecorder {
+public:
+	// [first, first + count) 범위의 draw를 commandBuffer에 기록한다 (thread는 VEjobSystem::threadIndex)
+	using RecordRange = std::function<void(vk::CommandBuffer commandBuffer, uint32_t thread, uint32_t first, uint32_t count)>;
+
+	void init(vk::Device device, uint32_t queueFamily, uint32_t framesInFlight, VEjobSystem& jobs);
+	void cleanUp();
+
+	// 동시에 기록할 수 있는 thread 수 (main + worker)
+	uint32_t getThreadCount() const { return jobs ? jobs->getWorkerCount() + 1 : 1; }
+
+	// 이 slot의 이전 frame이 GPU에서 끝난 뒤 (VEbase::beginFrame 이후) 호출
+	vk::CommandBuffer beginFrame(uint32_t frameIndex);
+
+	// minPerThread보다 적게 나뉘면 thread를 덜 쓴다
+	void recordParallel(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance,
+		uint32_t drawCount, const RecordRange& record, uint32_t minPerThread = 256);
+
+	// 마지막 recordParallel의 CPU 시간 (ms)
+	double getLastRecordMs() const { return lastRecordMs; }
+	void printStats(std::ostream& out) const;
+private:
+	struct ThreadPool {
+		vk::CommandPool pool;
+		std::vector<vk::CommandBuffer> secondaries;
+		uint32_t used{ 0 };		// 이번 frame에 사용한 secondary 수
+	};
+
+	struct Frame {
+		vk::CommandPool primaryPool;
+		vk::CommandBuffer primary;
+		std::vector<ThreadPool> threads;
+	};
+
+	vk::Device device;
+	VEjobSystem* jobs{ nullptr };
+	std::vector<Frame> frames;
+	Frame* current{ nullptr };
+
+	double lastRecordMs{ 0.0 };
+	double totalRecordMs{ 0.0 };
+	uint32_t recordCount{ 0 };
+
+	vk::CommandBuffer acquireSecondary(ThreadPool& thread);
+};
@@ -0,0 +1,379 @@
+#include "VEculling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX__)
+#define VE_CULL_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VE_CULL_SSE
+#include <emmintrin.h>
+#endif
+
+// 배열 끝의 빈 자리 : 어느 평면과 비교해도 바깥으로 판정된다
+static constexpr float CULLED_RADIUS = std::numeric_limits<float>::lowest();
+
+static uint32_t padToLanes(uint32_t count) {
+	return (count + 7) & ~7u;
+}
+
+// mask의 bit가 켜진 lane의 번호를 이어 쓴다
+// 분기 없이 8칸을 모두 쓰고 보이는 것만 위치를 올린다 (visible은 8칸 여유가 있어야 한다)
+static inline uint32_t appendVisible(uint32_t mask, uint32_t base, uint32_t* visible, uint32_t written) {
+	for (uint32_t lane = 0; lane < 8; lane++) {
+		visible[written] = base + lane;
+		written += (mask >> lane) & 1;
+	}
+	return written;
+}
+
+// 범위 마지막 block에서 count를 넘는 lane은 끈다
+static inline uint32_t laneMask(uint32_t remaining) {
+	return remaining >= 8 ? 0xFFu : (1u << remaining) - 1;
+}
+
+// ---- Frustum ----
+
+VEfrustum VEfrustum::fromMatrix(const glm::mat4& clip) {
+	// glm은 column major : clip[column][row]
+	auto row = [&](int i) { return glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]); };
+
+	VEfrustum frustum{
+		.planes = {
+			row(3) + row(0),	// left
+			row(3) - row(0),	// right
+			row(3) + row(1),	// bottom (proj[1][1]을 뒤집었으면 top)
+			row(3) - row(1),	// top
+#ifdef GLM_FORCE_DEPTH_ZERO_TO_ONE
+			row(2),				// near (0 <= z)
+#else
+			row(3) + row(2),	// near (-w <= z)
+#endif
+			row(3) - row(2),	// far
+		},
+	};
+
+	// 거리 비교 (sphere 반지름)를 위해 normal 길이를 1로
+	for (auto& plane : frustum.planes) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return frustum;
+}
+
+bool VEfrustum::testSphere(const glm::vec3& center, float radius) const {
+	for (auto& plane : planes) {
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool VEfrustum::testBox(const glm::vec3& center, const glm::vec3& extent) const {
+	// normal 방향으로 가장 멀리 있는 꼭지점이 평면 바깥이면 box 전체가 바깥이다
+	for (auto& plane : planes) {
+		glm::vec3 normal{ plane };
+		if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extent) < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ---- Bounds ----
+
+uint32_t VEsphereBounds::add(const glm::vec3& center, float radius) {
+	if (count == x.size()) {
+		auto size = padToLanes(count + 1);
+		x.resize(size, 0.0f);
+		y.resize(size, 0.0f);
+		z.resize(size, 0.0f);
+		r.resize(size, CULLED_RADIUS);
+	}
+
+	auto index = count++;
+	set(index, center, radius);
+	return index;
+}
+
+void VEsphereBounds::set(uint32_t index, const glm::vec3& center, float radius) {
+	x[index] = center.x;
+	y[index] = center.y;
+	z[index] = center.z;
+	r[index] = radius;
+}
+
+void VEsphereBounds::clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+	r.clear();
+	count = 0;
+}
+
+uint32_t VEboxBounds::add(const glm::vec3& min, const glm::vec3& max) {
+	if (count == x.size()) {
+		auto size = padToLanes(count + 1);
+		x.resize(size, 0.0f);
+		y.resize(size, 0.0f);
+		z.resize(size, 0.0f);
+		ex.resize(size, CULLED_RADIUS);
+		ey.resize(size, CULLED_RADIUS);
+		ez.resize(size, CULLED_RADIUS);
+	}
+
+	auto index = count++;
+	set(index, min, max);
+	return index;
+}
+
+void VEboxBounds::set(uint32_t index, const glm::vec3& min, const glm::vec3& max) {
+	auto center = (min + max) * 0.5f;
+	auto extent = (max - min) * 0.5f;
+
+	x[index] = center.x;
+	y[index] = center.y;
+	z[index] = center.z;
+	ex[index] = extent.x;
+	ey[index] = extent.y;
+	ez[index] = extent.z;
+}
+
+void VEboxBounds::clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+	ex.clear();
+	ey.clear();
+	ez.clear();
+	count = 0;
+}
+
+// ---- Kernels ----
+// 평면 거리는 scalar 판정 (testSphere, testBox)과 같은 순서로 더해 결과가 같다
+
+const char* getCullingPath() {
+#if defined(VE_CULL_AVX)
+	return "avx";
+#elif defined(VE_CULL_SSE)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+uint32_t cullSpheres(const VEfrustum& frustum, const VEsphereBounds& bounds, uint32_t first, uint32_t count, uint32_t* visible) {
+	uint32_t written = 0;
+
+#if defined(VE_CULL_AVX)
+	__m256 px[6], py[6], pz[6], pw[6];
+	for (int p = 0; p < 6; p++) {
+		px[p] = _mm256_set1_ps(frustum.planes[p].x);
+		py[p] = _mm256_set1_ps(frustum.planes[p].y);
+		pz[p] = _mm256_set1_ps(frustum.planes[p].z);
+		pw[p] = _mm256_set1_ps(frustum.planes[p].w);
+	}
+
+	for (uint32_t i = 0; i < count; i += 8) {
+		auto index = first + i;
+		auto x = _mm256_loadu_ps(bounds.x.data() + index);
+		auto y = _mm256_loadu_ps(bounds.y.data() + index);
+		auto z = _mm256_loadu_ps(bounds.z.data() + index);
+		auto negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(bounds.r.data() + index));
+
+		auto inside = _mm256_cmp_ps(negRadius, negRadius, _CMP_EQ_OQ);	// 모두 true
+		for (int p = 0; p < 6; p++) {
+			auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(px[p], x), _mm256_mul_ps(py[p], y)), _mm256_mul_ps(pz[p], z)), pw[p]);
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+		}
+
+		auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside)) & laneMask(count - i);
+		written = appendVisible(mask, index, visible, written);
+	}
+#elif defined(VE_CULL_SSE)
+	__m128 px[6], py[6], pz[6], pw[6];
+	for (int p = 0; p < 6; p++) {
+		px[p] = _mm_set1_ps(frustum.planes[p].x);
+		py[p] = _mm_set1_ps(frustum.planes[p].y);
+		pz[p] = _mm_set1_ps(frustum.planes[p].z);
+		pw[p] = _mm_set1_ps(frustum.planes[p].w);
+	}
+
+	auto test4 = [&](uint32_t index) {
+		auto x = _mm_loadu_ps(bounds.x.data() + index);
+		auto y = _mm_loadu_ps(bounds.y.data() + index);
+		auto z = _mm_loadu_ps(bounds.z.data() + index);
+		auto negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(bounds.r.data() + index));
+
+		auto inside = _mm_cmpeq_ps(negRadius, negRadius);
+		for (int p = 0; p < 6; p++) {
+			auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(px[p], x), _mm_mul_ps(py[p], y)), _mm_mul_ps(pz[p], z)), pw[p]);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+		return static_cast<uint32_t>(_mm_movemask_ps(inside));
+	};
+
+	for (uint32_t i = 0; i < count; i += 8) {
+		auto index = first + i;
+		auto mask = (test4(index) | (test4(index + 4) << 4)) & laneMask(count - i);
+		written = appendVisible(mask, index, visible, written);
+	}
+#else
+	for (uint32_t i = 0; i < count; i++) {
+		auto index = first + i;
+		visible[written] = index;
+		written += frustum.testSphere(glm::vec3(bounds.x[index], bounds.y[index], bounds.z[index]), bounds.r[index]);
+	}
+#endif
+
+	return written;
+}
+
+uint32_t cullBoxes(const VEfrustum& frustum, const VEboxBounds& bounds, uint32_t first, uint32_t count, uint32_t* visible) {
+	uint32_t written = 0;
+
+#if defined(VE_CULL_AVX)
+	__m256 px[6], py[6], pz[6], pw[6];
+	__m256 ax[6], ay[6], az[6];		// |normal|
+	for (int p = 0; p < 6; p++) {
+		auto& plane = frustum.planes[p];
+		px[p] = _mm256_set1_ps(plane.x);
+		py[p] = _mm256_set1_ps(plane.y);
+		pz[p] = _mm256_set1_ps(plane.z);
+		pw[p] = _mm256_set1_ps(plane.w);
+		ax[p] = _mm256_set1_ps(std::abs(plane.x));
+		ay[p] = _mm256_set1_ps(std::abs(plane.y));
+		az[p] = _mm256_set1_ps(std::abs(plane.z));
+	}
+
+	for (uint32_t i = 0; i < count; i += 8) {
+		auto index = first + i;
+		auto x = _mm256_loadu_ps(bounds.x.data() + index);
+		auto y = _mm256_loadu_ps(bounds.y.data() + index);
+		auto z = _mm256_loadu_ps(bounds.z.data() + index);
+		auto ex = _mm256_loadu_ps(bounds.ex.data() + index);
+		auto ey = _mm256_loadu_ps(bounds.ey.data() + index);
+		auto ez = _mm256_loadu_ps(bounds.ez.data() + index);
+
+		auto zero = _mm256_setzero_ps();
+		auto inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+		for (int p = 0; p < 6; p++) {
+			auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(px[p], x), _mm256_mul_ps(py[p], y)), _mm256_mul_ps(pz[p], z)), pw[p]);
+			auto reach = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)), _mm256_mul_ps(az[p], ez));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_GE_OQ));
+		}
+
+		auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside)) & laneMask(count - i);
+		written = appendVisible(mask, index, visible, written);
+	}
+#elif defined(VE_CULL_SSE)
+	__m128 px[6], py[6], pz[6], pw[6];
+	__m128 ax[6], ay[6], az[6];
+	for (int p = 0; p < 6; p++) {
+		auto& plane = frustum.planes[p];
+		px[p] = _mm_set1_ps(plane.x);
+		py[p] = _mm_set1_ps(plane.y);
+		pz[p] = _mm_set1_ps(plane.z);
+		pw[p] = _mm_set1_ps(plane.w);
+		ax[p] = _mm_set1_ps(std::abs(plane.x));
+		ay[p] = _mm_set1_ps(std::abs(plane.y));
+		az[p] = _mm_set1_ps(std::abs(plane.z));
+	}
+
+	auto test4 = [&](uint32_t index) {
+		auto x = _mm_loadu_ps(bounds.x.data() + index);
+		auto y = _mm_loadu_ps(bounds.y.data() + index);
+		auto z = _mm_loadu_ps(bounds.z.data() + index);
+		auto ex = _mm_loadu_ps(bounds.ex.data() + index);
+		auto ey = _mm_loadu_ps(bounds.ey.data() + index);
+		auto ez = _mm_loadu_ps(bounds.ez.data() + index);
+
+		auto zero = _mm_setzero_ps();
+		auto inside = _mm_cmpeq_ps(zero, zero);
+		for (int p = 0; p < 6; p++) {
+			auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(px[p], x), _mm_mul_ps(py[p], y)), _mm_mul_ps(pz[p], z)), pw[p]);
+			auto reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), zero));
+		}
+		return static_cast<uint32_t>(_mm_movemask_ps(inside));
+	};
+
+	for (uint32_t i = 0; i < count; i += 8) {
+		auto index = first + i;
+		auto mask = (test4(index) | (test4(index + 4) << 4)) & laneMask(count - i);
+		written = appendVisible(mask, index, visible, written);
+	}
+#else
+	for (uint32_t i = 0; i < count; i++) {
+		auto index = first + i;
+		visible[written] = index;
+		written += frustum.testBox(glm::vec3(bounds.x[index], bounds.y[index], bounds.z[index]),
+			glm::vec3(bounds.ex[index], bounds.ey[index], bounds.ez[index]));
+	}
+#endif
+
+	return written;
+}
+
+// ---- Culler ----
+
+template <typename Bounds, typename Func>
+void VEculler::cullChunks(VEjobSystem* jobs, const Bounds& bounds, Func func) {
+	auto count = bounds.size();
+	auto chunks = (count + CHUNK - 1) / CHUNK;
+
+	// chunk 마다 CHUNK 칸 (결과를 쓰는 동안 chunk끼리 겹치지 않는다)
+	if (visible.size() < static_cast<size_t>(chunks) * CHUNK) {
+		visible.resize(static_cast<size_t>(chunks) * CHUNK);
+	}
+	chunkCounts.resize(chunks);
+
+	auto cullRange = [&](uint32_t firstChunk, uint32_t chunkCount) {
+		for (auto chunk = firstChunk; chunk < firstChunk + chunkCount; chunk++) {
+			auto first = chunk * CHUNK;
+			chunkCounts[chunk] = func(first, std::min(CHUNK, count - first), visible.data() + first);
+		}
+	};
+
+	if (jobs && chunks > 1) {
+		jobs->parallelFor(chunks, 1, cullRange);
+	}
+	else {
+		cullRange(0, chunks);
+	}
+
+	// chunk 결과를 앞으로 당겨 이어 붙인다 (첫 chunk는 이미 제자리)
+	visibleCount = chunks > 0 ? chunkCounts[0] : 0;
+	for (uint32_t chunk = 1; chunk < chunks; chunk++) {
+		memmove(visible.data() + visibleCount, visible.data() + static_cast<size_t>(chunk) * CHUNK,
+			chunkCounts[chunk] * sizeof(uint32_t));
+		visibleCount += chunkCounts[chunk];
+	}
+
+	testedCount = count;
+}
+
+void VEculler::cull(VEjobSystem* jobs, const VEfrustum& frustum, const VEsphereBounds& bounds) {
+	cullChunks(jobs, bounds, [&](uint32_t first, uint32_t count, uint32_t* out) {
+		return cullSpheres(frustum, bounds, first, count, out);
+	});
+}
+
+void VEculler::cull(VEjobSystem* jobs, const VEfrustum& frustum, const VEboxBounds& bounds) {
+	cullChunks(jobs, bounds, [&](uint32_t first, uint32_t count, uint32_t* out) {
+		return cullBoxes(frustum, bounds, first, count, out);
+	});
+}
+
+void VEculler::printStats(std::ostream& out) const {
+	out << "culling (" << getCullingPath() << "): " << visibleCount << " / " << testedCount << " visible\n";
+}
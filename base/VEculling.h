@@ -0,0 +1,96 @@
+#pragma once
+
+#include "VEjobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// ------------- Frustum Culling ----------------
+//
+// object bounds를 structure of arrays (x, y, z, r 배열)로 저장하고 frustum 평면 6개와 8개씩 비교해서
+// 보이는 object 번호만 앞에서부터 채운다 (compact visible list).
+//	- AVX (VE_ENABLE_AVX2로 빌드)	: 8 lane 한 번
+//	- SSE2 (x86-64 기본)			: 4 lane 두 번
+//	- 그 외							: scalar
+// 배열 길이는 항상 8의 배수이고, 남는 자리에는 항상 바깥으로 판정되는 값이 들어 있어 tail 처리가 없다.
+//
+// frustum은 clip 행렬에서 평면을 뽑는다 (Gribb / Hartmann).
+// proj * view 를 넘기면 world 공간, proj * view * model 을 넘기면 그 model 공간의 bounds와 비교한다.
+// 경계에 걸친 object는 보이는 것으로 판정한다 (보수적).
+//
+// VEculler::cull은 object를 CHUNK 단위로 나눠 job system으로 병렬 처리한 뒤 chunk 순서대로 이어 붙인다
+// (결과는 object 번호 순서로 정렬되어 있다).
+
+struct VEfrustum {
+	// xyz = 안쪽을 향하는 단위 normal, w = 거리 (dot(n, p) + w >= 0 이면 평면 안쪽)
+	glm::vec4 planes[6];
+
+	static VEfrustum fromMatrix(const glm::mat4& clip);
+
+	bool testSphere(const glm::vec3& center, float radius) const;
+	bool testBox(const glm::vec3& center, const glm::vec3& extent) const;
+};
+
+// bounding sphere (중심, 반지름)
+class VEsphereBounds {
+public:
+	uint32_t add(const glm::vec3& center, float radius);
+	void set(uint32_t index, const glm::vec3& center, float radius);
+	void clear();
+
+	uint32_t size() const { return count; }
+
+	std::vector<float> x, y, z, r;
+private:
+	uint32_t count{ 0 };
+};
+
+// AABB (중심, 반 크기)
+class VEboxBounds {
+public:
+	uint32_t add(const glm::vec3& min, const glm::vec3& max);
+	void set(uint32_t index, const glm::vec3& min, const glm::vec3& max);
+	void clear();
+
+	uint32_t size() const { return count; }
+
+	std::vector<float> x, y, z;			// 중심
+	std::vector<float> ex, ey, ez;		// 반 크기
+private:
+	uint32_t count{ 0 };
+};
+
+// [first, first + count) 범위를 검사해서 보이는 object 번호를 visible에 쓰고 개수를 돌려준다
+// first는 8의 배수여야 하고, visible은 count를 8의 배수로 올린 만큼 담을 수 있어야 한다 (8칸씩 쓴다)
+uint32_t cullSpheres(const VEfrustum& frustum, const VEsphereBounds& bounds, uint32_t first, uint32_t count, uint32_t* visible);
+uint32_t cullBoxes(const VEfrustum& frustum, const VEboxBounds& bounds, uint32_t first, uint32_t count, uint32_t* visible);
+
+// 어느 SIMD 경로로 빌드 되었는지 ("avx", "sse2", "scalar")
+const char* getCullingPath();
+
+class VEculler {
+public:
+	// job 하나가 검사하는 object 수 (8의 배수)
+	static constexpr uint32_t CHUNK = 16 * 1024;
+
+	// jobs가 nullptr이면 호출한 thread 하나에서 검사한다
+	void cull(VEjobSystem* jobs, const VEfrustum& frustum, const VEsphereBounds& bounds);
+	void cull(VEjobSystem* jobs, const VEfrustum& frustum, const VEboxBounds& bounds);
+
+	// 마지막 cull 결과 (다음 cull 까지 유효)
+	const uint32_t* getVisible() const { return visible.data(); }
+	uint32_t getVisibleCount() const { return visibleCount; }
+
+	void printStats(std::ostream& out) const;
+private:
+	std::vector<uint32_t> visible;		// chunk 별로 CHUNK 칸씩 쓴 뒤 앞으로 당긴다
+	std::vector<uint32_t> chunkCounts;
+	uint32_t visibleCount{ 0 };
+	uint32_t testedCount{ 0 };
+
+	template <typename Bounds, typename Func>
+	void cullChunks(VEjobSystem* jobs, const Bounds& bounds, Func func);
+};
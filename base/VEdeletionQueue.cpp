@@ -0,0 +1,68 @@
+#include "VEdeletionQueue.h"
+
+#include <algorithm>
+
+void VEdeletionQueue::init(vk::Device device, VEallocator& allocator, uint32_t maxPerCollect) {
+	this->device = device;
+	this->allocator = &allocator;
+	this->maxPerCollect = std::max(1u, maxPerCollect);
+}
+
+void VEdeletionQueue::cleanUp() {
+	flush();
+}
+
+void VEdeletionQueue::push(uint64_t frame, Object object) {
+	// 번호가 뒤바뀌어 들어와도 앞의 것보다 먼저 파괴되지 않도록 한다
+	if (!entries.empty()) {
+		frame = std::max(frame, entries.back().frame);
+	}
+
+	entries.push_back(Entry{
+		.frame = frame,
+		.object = std::move(object),
+	});
+
+	maxPending = std::max(maxPending, entries.size());
+}
+
+uint32_t VEdeletionQueue::collect(uint64_t retiredFrame) {
+	uint32_t count = 0;
+
+	while (!entries.empty() && count < maxPerCollect && entries.front().frame <= retiredFrame) {
+		destroy(entries.front().object);
+		entries.pop_front();
+		count++;
+	}
+
+	destroyedCount += count;
+	return count;
+}
+
+void VEdeletionQueue::flush() {
+	while (!entries.empty()) {
+		destroy(entries.front().object);
+		entries.pop_front();
+		destroyedCount++;
+	}
+}
+
+void VEdeletionQueue::destroy(Object& object) {
+	std::visit([&](auto& handle) {
+		using T = std::decay_t<decltype(handle)>;
+
+		if constexpr (std::is_same_v<T, VEallocation>) {
+			allocator->free(handle);
+		}
+		else if constexpr (std::is_same_v<T, std::function<void()>>) {
+			if (handle) handle();
+		}
+		else {
+			device.destroy(handle);
+		}
+	}, object);
+}
+
+void VEdeletionQueue::printStats(std::ostream& out) const {
+	out << "deletion queue: " << destroyedCount << " destroyed, " << entries.size() << " pending (max " << maxPending << ")\n";
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include "VEallocator.h"
+
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <variant>
+
+// ------------- Deletion Queue ----------------
+//
+// GPU가 아직 사용중일 수 있는 object의 파괴를 마지막으로 사용한 frame이 끝날 때까지 미룬다.
+// push 할 때 frame 번호 (frame timeline 값)를 붙이고, collect(retiredFrame)에서
+// 완료된 frame의 object만 push 한 순서대로 파괴한다.
+//
+// 한 번의 collect에서 파괴하는 개수는 maxPerCollect로 제한하고, 남은 것은 다음 frame으로 넘긴다.
+// (한꺼번에 많은 resource를 내릴 때 한 frame에 파괴 비용이 몰리지 않도록)
+// buffer / image와 그 메모리처럼 순서가 필요한 것은 같은 frame 번호로 연달아 push 하면 된다.
+
+class VEdeletionQueue {
+public:
+	using Object = std::variant<
+		vk::Buffer,
+		vk::Image,
+		vk::ImageView,
+		vk::Sampler,
+		vk::Framebuffer,
+		vk::RenderPass,
+		vk::Pipeline,
+		vk::PipelineLayout,
+		vk::DescriptorPool,
+		vk::DescriptorSetLayout,
+		vk::SwapchainKHR,
+		VEallocation,
+		std::function<void()>>;
+
+	void init(vk::Device device, VEallocator& allocator, uint32_t maxPerCollect = 64);
+	// 남아있는 것을 모두 파괴 (device idle 상태에서만)
+	void cleanUp();
+
+	void push(uint64_t frame, Object object);
+
+	// retiredFrame 까지 끝난 object를 최대 maxPerCollect 개 파괴하고, 파괴한 개수를 돌려준다
+	uint32_t collect(uint64_t retiredFrame);
+	// 완료 여부와 상관없이 모두 파괴 (device idle 상태에서만)
+	void flush();
+
+	size_t getPendingCount() const { return entries.size(); }
+	void printStats(std::ostream& out) const;
+private:
+	struct Entry {
+		uint64_t frame;
+		Object object;
+	};
+
+	vk::Device device;
+	VEallocator* allocator{ nullptr };
+	uint32_t maxPerCollect{ 64 };
+
+	std::deque<Entry> entries;	// frame 번호 순 (push는 항상 같거나 큰 번호로 들어온다)
+
+	uint64_t destroyedCount{ 0 };
+	size_t maxPending{ 0 };
+
+	void destroy(Object& object);
+};
@@ -0,0 +1,198 @@
+#include "VEdescriptor.h"
+#include "VEprofiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// ---- Descriptor Allocator ----
+
+void VEdescriptorAllocator::init(vk::Device device, std::vector<PoolSizeRatio> ratios, uint32_t setsPerPool, uint32_t maxSetsPerPool) {
+	this->device = device;
+	this->ratios = std::move(ratios);
+	this->setsPerPool = std::max(1u, setsPerPool);
+	this->maxSetsPerPool = std::max(this->setsPerPool, maxSetsPerPool);
+
+	readyPools.push_back(createPool(this->setsPerPool));
+}
+
+void VEdescriptorAllocator::cleanUp() {
+	for (auto pool : fullPools) {
+		device.destroyDescriptorPool(pool);
+	}
+	for (auto pool : readyPools) {
+		device.destroyDescriptorPool(pool);
+	}
+	fullPools.clear();
+	readyPools.clear();
+}
+
+vk::DescriptorPool VEdescriptorAllocator::createPool(uint32_t setCount) {
+	std::vector<vk::DescriptorPoolSize> poolSizes;
+	for (auto& ratio : ratios) {
+		poolSizes.push_back(vk::DescriptorPoolSize{
+			.type = ratio.type,
+			.descriptorCount = std::max(1u, static_cast<uint32_t>(ratio.ratio * setCount)),
+		});
+	}
+
+	vk::DescriptorPoolCreateInfo poolInfo{
+		.maxSets = setCount,
+		.poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+		.pPoolSizes = poolSizes.data(),
+	};
+
+	return device.createDescriptorPool(poolInfo);
+}
+
+vk::DescriptorPool VEdescriptorAllocator::getPool() {
+	if (!readyPools.empty()) {
+		return readyPools.back();
+	}
+
+	// 이어 붙일 때마다 두 배로 키운다
+	setsPerPool = std::min(setsPerPool * 2, maxSetsPerPool);
+	growCount++;
+
+	readyPools.push_back(createPool(setsPerPool));
+	return readyPools.back();
+}
+
+vk::DescriptorSet VEdescriptorAllocator::allocate(vk::DescriptorSetLayout layout) {
+	auto pool = getPool();
+
+	vk::DescriptorSetAllocateInfo allocInfo{
+		.descriptorPool = pool,
+		.descriptorSetCount = 1,
+		.pSetLayouts = &layout,
+	};
+
+	// 실패를 예외 대신 결과 값으로 받기 위해 C API를 쓴다
+	VkDescriptorSet set{};
+	auto result = static_cast<vk::Result>(VULKAN_HPP_DEFAULT_DISPATCHER.vkAllocateDescriptorSets(static_cast<VkDevice>(device),
+		reinterpret_cast<const VkDescriptorSetAllocateInfo*>(&allocInfo), &set));
+
+	if (result == vk::Result::eErrorOutOfPoolMemory || result == vk::Result::eErrorFragmentedPool) {
+		// 가득 찬 pool은 reset 전까지 빼 둔다
+		readyPools.pop_back();
+		fullPools.push_back(pool);
+
+		allocInfo.descriptorPool = getPool();
+		result = static_cast<vk::Result>(VULKAN_HPP_DEFAULT_DISPATCHER.vkAllocateDescriptorSets(static_cast<VkDevice>(device),
+			reinterpret_cast<const VkDescriptorSetAllocateInfo*>(&allocInfo), &set));
+	}
+
+	if (result != vk::Result::eSuccess) {
+		throw std::runtime_error("failed to allocate descriptor set : " + vk::to_string(result));
+	}
+
+	allocatedSets++;
+	return set;
+}
+
+void VEdescriptorAllocator::reset() {
+	for (auto pool : readyPools) {
+		device.resetDescriptorPool(pool);
+	}
+	for (auto pool : fullPools) {
+		device.resetDescriptorPool(pool);
+		readyPools.push_back(pool);
+	}
+	fullPools.clear();
+}
+
+void VEdescriptorAllocator::printStats(std::ostream& out, const char* name) const {
+	out << name << ": " << allocatedSets << " sets allocated, " << getPoolCount() << " pools (grown " << growCount
+		<< " times, " << setsPerPool << " sets / pool)\n";
+}
+
+// ---- Frame Descriptors ----
+
+void VEframeDescriptors::init(vk::Device device, uint32_t framesInFlight, const std::vector<VEdescriptorAllocator::PoolSizeRatio>& ratios,
+	uint32_t setsPerPool) {
+	frames.resize(framesInFlight);
+	for (auto& frame : frames) {
+		frame.init(device, ratios, setsPerPool);
+	}
+	current = &frames.front();
+}
+
+void VEframeDescriptors::cleanUp() {
+	for (auto& frame : frames) {
+		frame.cleanUp();
+	}
+	frames.clear();
+	current = nullptr;
+}
+
+void VEframeDescriptors::beginFrame(uint32_t frameIndex) {
+	VE_PROFILE_FUNCTION();
+
+	current = &frames[frameIndex % frames.size()];
+	current->reset();
+}
+
+void VEframeDescriptors::printStats(std::ostream& out) const {
+	uint64_t pools = 0;
+	for (auto& frame : frames) {
+		pools += frame.getPoolCount();
+	}
+
+	out << "frame descriptors: " << frames.size() << " frames, " << pools << " pools\n";
+}
+
+// ---- Descriptor Update Template ----
+
+void VEdescriptorTemplate::init(vk::Device device, vk::DescriptorSetLayout layout, const std::vector<Entry>& entries) {
+	this->device = device;
+
+	std::vector<vk::DescriptorUpdateTemplateEntry> templateEntries;
+	for (auto& entry : entries) {
+		size_t stride = entry.stride;
+		if (stride == 0) {
+			switch (entry.type) {
+			case vk::DescriptorType::eUniformBuffer:
+			case vk::DescriptorType::eStorageBuffer:
+			case vk::DescriptorType::eUniformBufferDynamic:
+			case vk::DescriptorType::eStorageBufferDynamic:
+				stride = sizeof(vk::DescriptorBufferInfo);
+				break;
+			case vk::DescriptorType::eUniformTexelBuffer:
+			case vk::DescriptorType::eStorageTexelBuffer:
+				stride = sizeof(vk::BufferView);
+				break;
+			default:
+				stride = sizeof(vk::DescriptorImageInfo);
+				break;
+			}
+		}
+
+		templateEntries.push_back(vk::DescriptorUpdateTemplateEntry{
+			.dstBinding = entry.binding,
+			.dstArrayElement = entry.arrayElement,
+			.descriptorCount = entry.count,
+			.descriptorType = entry.type,
+			.offset = entry.offset,
+			.stride = stride,
+		});
+	}
+
+	vk::DescriptorUpdateTemplateCreateInfo templateInfo{
+		.descriptorUpdateEntryCount = static_cast<uint32_t>(templateEntries.size()),
+		.pDescriptorUpdateEntries = templateEntries.data(),
+		.templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet,
+		.descriptorSetLayout = layout,
+	};
+
+	handle = device.createDescriptorUpdateTemplate(templateInfo);
+}
+
+void VEdescriptorTemplate::cleanUp() {
+	if (handle) {
+		device.destroyDescriptorUpdateTemplate(handle);
+		handle = nullptr;
+	}
+}
+
+void VEdescriptorTemplate::update(vk::DescriptorSet set, const void* data) const {
+	device.updateDescriptorSetWithTemplate(set, handle, data);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include <ostream>
+#include <vector>
+
+// ------------- Descriptor Allocator ----------------
+//
+// descriptor pool 하나를 미리 크게 잡는 대신 pool을 이어 붙여가며 늘린다.
+//	- allocate(layout)	: 현재 pool에서 할당하고, 모자라면 (eErrorOutOfPoolMemory / eErrorFragmentedPool)
+//						  다음 pool로 넘어가 다시 시도한다. 새 pool은 이전 pool의 두 배 크기 (maxSetsPerPool 까지)
+//	- reset()			: 모든 pool을 vkResetDescriptorPool로 한꺼번에 비운다 (set 개별 free 없음)
+// pool 크기는 set 수 x descriptor 타입 별 비율로 정한다.
+//
+// VEframeDescriptors는 frame in flight slot 마다 allocator를 하나씩 두고,
+// 그 slot의 frame이 GPU에서 끝난 뒤 (VEbase::beginFrame) 통째로 reset 한다.
+// frame 마다 새로 쓰는 per-draw set은 여기서 할당하면 free / 재사용을 신경쓰지 않아도 된다.
+//
+// 한 allocator는 한 thread에서만 사용해야 한다.
+
+class VEdescriptorAllocator {
+public:
+	// set 하나 당 type descriptor를 ratio 개 만큼 잡는다
+	struct PoolSizeRatio {
+		vk::DescriptorType type;
+		float ratio;
+	};
+
+	void init(vk::Device device, std::vector<PoolSizeRatio> ratios, uint32_t setsPerPool = 64, uint32_t maxSetsPerPool = 4096);
+	void cleanUp();
+
+	vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+	void reset();
+
+	uint32_t getPoolCount() const { return static_cast<uint32_t>(fullPools.size() + readyPools.size()); }
+	void printStats(std::ostream& out, const char* name) const;
+private:
+	vk::Device device;
+	std::vector<PoolSizeRatio> ratios;
+	uint32_t setsPerPool{ 64 };
+	uint32_t maxSetsPerPool{ 4096 };
+
+	std::vector<vk::DescriptorPool> fullPools;	// 할당에 실패한 pool (reset 전까지 쓰지 않는다)
+	std::vector<vk::DescriptorPool> readyPools;	// 마지막이 현재 pool
+
+	uint64_t allocatedSets{ 0 };
+	uint32_t growCount{ 0 };
+
+	vk::DescriptorPool getPool();
+	vk::DescriptorPool createPool(uint32_t setCount);
+};
+
+class VEframeDescriptors {
+public:
+	void init(vk::Device device, uint32_t framesInFlight, const std::vector<VEdescriptorAllocator::PoolSizeRatio>& ratios,
+		uint32_t setsPerPool = 256);
+	void cleanUp();
+
+	// 이 slot의 이전 frame이 GPU에서 끝난 뒤 호출
+	void beginFrame(uint32_t frameIndex);
+	vk::DescriptorSet allocate(vk::DescriptorSetLayout layout) { return current->allocate(layout); }
+
+	void printStats(std::ostream& out) const;
+private:
+	std::vector<VEdescriptorAllocator> frames;
+	VEdescriptorAllocator* current{ nullptr };
+};
+
+// ------------- Descriptor Update Template ----------------
+//
+// vkUpdateDescriptorSets는 write 마다 VkWriteDescriptorSet을 채워 넘겨야 하지만,
+// update template은 set layout의 binding들이 CPU 쪽 struct 어디에 있는지를 미리 등록해두고
+// update(set, &data) 한 번으로 모든 binding을 쓴다 (driver가 write 해석을 미리 해 둔다).
+//
+// struct의 각 필드는 type에 맞는 vk::DescriptorBufferInfo / vk::DescriptorImageInfo / vk::BufferView 이어야 한다.
+//	struct Data { vk::DescriptorBufferInfo ubo; vk::DescriptorImageInfo albedo; };
+//	tmpl.init(device, layout, {
+//		{ .binding = 0, .type = vk::DescriptorType::eUniformBuffer, .offset = offsetof(Data, ubo) },
+//		{ .binding = 1, .type = vk::DescriptorType::eCombinedImageSampler, .offset = offsetof(Data, albedo) },
+//	});
+//	tmpl.update(set, data);
+
+class VEdescriptorTemplate {
+public:
+	struct Entry {
+		uint32_t binding{ 0 };
+		uint32_t arrayElement{ 0 };
+		uint32_t count{ 1 };
+		vk::DescriptorType type{ vk::DescriptorType::eUniformBuffer };
+		size_t offset{ 0 };		// data struct 안에서의 위치
+		size_t stride{ 0 };		// 배열일 때 원소 간격 (0 -> type 크기)
+	};
+
+	void init(vk::Device device, vk::DescriptorSetLayout layout, const std::vector<Entry>& entries);
+	void cleanUp();
+
+	void update(vk::DescriptorSet set, const void* data) const;
+
+	template <typename T>
+	void update(vk::DescriptorSet set, const T& data) const { update(set, static_cast<const void*>(&data)); }
+
+	vk::DescriptorUpdateTemplate getHandle() const { return handle; }
+private:
+	vk::Device device;
+	vk::DescriptorUpdateTemplate handle;
+};
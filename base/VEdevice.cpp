@@ -0,0 +1,211 @@
+#include "VEdevice.h"
+#include "VEbindless.h"
+
+#include <algorithm>
+#include <cstring>
+
+void VEdeviceFeatures::print(std::ostream& out) const {
+	auto flag = [&](const char* name, bool value) {
+		if (value) out << " " << name;
+	};
+
+	out << "device features:";
+	flag("timelineSemaphore", timelineSemaphore);
+	flag("synchronization2", synchronization2);
+	flag("dynamicRendering", dynamicRendering);
+	flag("descriptorIndexing", descriptorIndexing);
+	flag("bufferDeviceAddress", bufferDeviceAddress);
+	flag("drawIndirectCount", drawIndirectCount);
+	flag("multiDrawIndirect", multiDrawIndirect);
+	flag("memoryBudget", memoryBudget);
+	flag("pipelineCreationFeedback", pipelineCreationFeedback);
+	flag("presentWait", presentWait);
+	out << "\n";
+}
+
+bool VEdeviceCapabilities::hasExtension(const char* name) const {
+	return std::find(extensions.begin(), extensions.end(), name) != extensions.end();
+}
+
+VEdeviceCapabilities queryDeviceCapabilities(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR surface,
+	const std::vector<const char*>& requiredExtensions) {
+	VEdeviceCapabilities capabilities{
+		.physicalDevice = physicalDevice,
+		.properties = physicalDevice.getProperties(),
+		.memoryProperties = physicalDevice.getMemoryProperties(),
+	};
+
+	// timeline semaphore 등 1.2 기능을 사용한다 (1.2 미만에서는 Vulkan12Features를 조회할 수도 없다)
+	if (capabilities.properties.apiVersion < VK_API_VERSION_1_2) {
+		capabilities.reason = "Vulkan 1.2 is not supported";
+		return capabilities;
+	}
+
+	for (uint32_t i = 0; i < capabilities.memoryProperties.memoryHeapCount; i++) {
+		auto& heap = capabilities.memoryProperties.memoryHeaps[i];
+		if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+			capabilities.deviceLocalBytes += heap.size;
+		}
+	}
+
+	for (auto& extension : physicalDevice.enumerateDeviceExtensionProperties()) {
+		capabilities.extensions.push_back(extension.extensionName.data());
+	}
+
+	capabilities.queueFamilies = findQueueFamilies(physicalDevice, surface);
+
+	// extension feature struct는 extension이 있을 때만 chain에 넣는다
+	vk::PhysicalDeviceFeatures2 features2{};
+	vk::PhysicalDeviceVulkan12Features features12{};
+	vk::PhysicalDeviceSynchronization2FeaturesKHR synchronization2{};
+	vk::PhysicalDeviceDynamicRenderingFeaturesKHR dynamicRendering{};
+	vk::PhysicalDevicePresentIdFeaturesKHR presentId{};
+	vk::PhysicalDevicePresentWaitFeaturesKHR presentWait{};
+
+	void** next = &features2.pNext;
+	auto chain = [&](auto& feature) {
+		*next = &feature;
+		next = &feature.pNext;
+	};
+
+	chain(features12);
+	if (capabilities.hasExtension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) chain(synchronization2);
+	if (capabilities.hasExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) chain(dynamicRendering);
+	bool hasPresentWait = capabilities.hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+		capabilities.hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+	if (hasPresentWait) {
+		chain(presentId);
+		chain(presentWait);
+	}
+
+	physicalDevice.getFeatures2(&features2);
+
+	capabilities.features = features2.features;
+	capabilities.features12 = features12;
+	capabilities.features12.pNext = nullptr;
+
+	auto& supported = capabilities.supported;
+	supported.timelineSemaphore = features12.timelineSemaphore;
+	supported.synchronization2 = synchronization2.synchronization2;
+	supported.dynamicRendering = dynamicRendering.dynamicRendering;
+	supported.descriptorIndexing = VEbindless::isSupported(features12);
+	supported.bufferDeviceAddress = features12.bufferDeviceAddress;
+	supported.drawIndirectCount = features12.drawIndirectCount;
+	supported.multiDrawIndirect = capabilities.features.multiDrawIndirect && capabilities.features.drawIndirectFirstInstance;
+	supported.memoryBudget = capabilities.hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	supported.pipelineCreationFeedback = capabilities.hasExtension(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+	supported.presentWait = hasPresentWait && presentId.presentId && presentWait.presentWait;
+
+	for (auto name : requiredExtensions) {
+		if (!capabilities.hasExtension(name)) {
+			capabilities.reason = std::string("missing extension ") + name;
+			return capabilities;
+		}
+	}
+
+	if (!capabilities.queueFamilies.isComplete()) {
+		capabilities.reason = "no graphics / present queue family";
+		return capabilities;
+	}
+
+	if (!supported.timelineSemaphore) {
+		capabilities.reason = "timeline semaphore is not supported";
+		return capabilities;
+	}
+
+	// headless (surface 없음) : present / swapchain 조건은 확인하지 않는다
+	if (surface) {
+		capabilities.surfaceFormats = physicalDevice.getSurfaceFormatsKHR(surface);
+		capabilities.presentModes = physicalDevice.getSurfacePresentModesKHR(surface);
+
+		if (capabilities.surfaceFormats.empty() || capabilities.presentModes.empty()) {
+			capabilities.reason = "surface has no format or present mode";
+			return capabilities;
+		}
+	}
+
+	capabilities.suitable = true;
+	capabilities.score = scoreDevice(capabilities);
+	return capabilities;
+}
+
+uint64_t scoreDevice(const VEdeviceCapabilities& capabilities) {
+	if (!capabilities.suitable) return 0;
+
+	uint64_t score = 1;
+
+	switch (capabilities.properties.deviceType) {
+	case vk::PhysicalDeviceType::eDiscreteGpu:		score += 100000; break;
+	case vk::PhysicalDeviceType::eIntegratedGpu:	score += 50000; break;
+	case vk::PhysicalDeviceType::eVirtualGpu:		score += 20000; break;
+	case vk::PhysicalDeviceType::eCpu:				score += 1000; break;
+	default: break;
+	}
+
+	// device local 메모리 : 256MB 당 1점 (같은 type 안에서 순위를 정하는 정도)
+	score += std::min<uint64_t>(capabilities.deviceLocalBytes >> 28, 10000);
+
+	// 전용 transfer / compute family는 upload와 compute를 graphics와 겹칠 수 있다
+	auto& queues = capabilities.queueFamilies;
+	if (queues.transferFamily != queues.graphicsFamily) score += 500;
+	if (queues.computeFamily) score += 500;
+
+	auto& supported = capabilities.supported;
+	for (bool feature : { supported.synchronization2, supported.dynamicRendering, supported.descriptorIndexing,
+		supported.bufferDeviceAddress, supported.drawIndirectCount, supported.memoryBudget }) {
+		if (feature) score += 100;
+	}
+
+	return score;
+}
+
+QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice device, vk::SurfaceKHR surface) {
+	auto queueFamilies{ device.getQueueFamilyProperties() };
+
+	QueueFamilyIndices indices{};
+
+	int i{};
+	for (const auto& queueFamily : queueFamilies) {
+		if (!indices.isComplete()) {
+			if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) {
+				indices.graphicsFamily = i;
+			}
+
+			// present support (headless 에서는 graphics queue가 present 역할까지 맡는다)
+			if (surface ? device.getSurfaceSupportKHR(i, surface) : indices.graphicsFamily == i) {
+				indices.presentFamily = i;
+			}
+		}
+
+		// graphics, compute를 지원하지 않는 transfer 전용 family (보통 DMA engine)
+		auto flags = queueFamily.queueFlags;
+		if (!indices.transferFamily && (flags & vk::QueueFlagBits::eTransfer) &&
+			!(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+			indices.transferFamily = i;
+		}
+
+		// graphics와 분리된 compute family
+		if (!indices.computeFamily && (flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics)) {
+			indices.computeFamily = i;
+		}
+
+		i++;
+	}
+
+	// 전용 family가 없으면 graphics queue로 transfer (graphics family는 암시적으로 transfer 지원)
+	if (!indices.transferFamily) {
+		indices.transferFamily = indices.graphicsFamily;
+	}
+
+	return indices;
+}
+
+SwapChainSupportDetails querySwapChainSupport(vk::PhysicalDevice device, vk::SurfaceKHR surface) {
+	SwapChainSupportDetails details{
+		.capabilities = device.getSurfaceCapabilitiesKHR(surface),
+		.formats = device.getSurfaceFormatsKHR(surface),
+		.presentModes = device.getSurfacePresentModesKHR(surface),
+	};
+
+	return details;
+}
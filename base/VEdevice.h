@@ -0,0 +1,90 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ------------- Device Capabilities ----------------
+//
+// physical device 마다 property / feature / extension / queue family / surface 지원을 한 번만 조회해서
+// VEdeviceCapabilities로 들고 다닌다 (swapchain 생성 등에서 findQueueFamilies를 다시 부르지 않는다).
+// surface capabilities (현재 크기)는 resize 때 바뀌므로 snapshot에 넣지 않는다.
+//
+// pickPhysicalDevice는 조건을 만족하는 device 중 점수가 가장 높은 것을 고른다.
+//	- device type (discrete > integrated > virtual > cpu)
+//	- device local 메모리 크기
+//	- queue 구성 (transfer 전용 family, graphics와 분리된 compute family)
+//	- 성능에 관련된 기능 지원 (VEdeviceFeatures)
+//
+// VEdeviceFeatures는 지원 여부 (capabilities.supported)와 실제로 켠 것 (VEbase::enabledFeatures) 두 곳에 쓰인다.
+// subsystem은 enabledFeatures를 보고 빠른 경로를 고른다.
+
+struct QueueFamilyIndices {
+	std::optional<uint32_t> graphicsFamily;
+	std::optional<uint32_t> presentFamily;
+	std::optional<uint32_t> transferFamily;	// 전용 family가 없으면 graphicsFamily와 같다
+	std::optional<uint32_t> computeFamily;	// graphics를 지원하지 않는 compute family (async compute)
+
+	bool isComplete() {
+		return graphicsFamily.has_value() && presentFamily.has_value();
+	}
+};
+
+struct SwapChainSupportDetails {
+	vk::SurfaceCapabilitiesKHR capabilities;
+	std::vector<vk::SurfaceFormatKHR> formats;
+	std::vector<vk::PresentModeKHR> presentModes;
+};
+
+struct VEdeviceFeatures {
+	bool timelineSemaphore{ false };
+	bool synchronization2{ false };		// VK_KHR_synchronization2
+	bool dynamicRendering{ false };		// VK_KHR_dynamic_rendering
+	bool descriptorIndexing{ false };	// bindless에 필요한 descriptor indexing 기능 전체
+	bool bufferDeviceAddress{ false };
+	bool drawIndirectCount{ false };
+	bool multiDrawIndirect{ false };	// multiDrawIndirect + drawIndirectFirstInstance (GPU culling)
+	bool memoryBudget{ false };			// VK_EXT_memory_budget
+	bool pipelineCreationFeedback{ false };
+	bool presentWait{ false };			// VK_KHR_present_id + VK_KHR_present_wait
+
+	void print(std::ostream& out) const;
+};
+
+struct VEdeviceCapabilities {
+	vk::PhysicalDevice physicalDevice;
+	vk::PhysicalDeviceProperties properties;
+	vk::PhysicalDeviceMemoryProperties memoryProperties;
+	vk::DeviceSize deviceLocalBytes{ 0 };
+
+	QueueFamilyIndices queueFamilies;
+	std::vector<std::string> extensions;
+
+	// 조회한 feature (pNext는 비어있다)
+	vk::PhysicalDeviceFeatures features;
+	vk::PhysicalDeviceVulkan12Features features12;
+
+	VEdeviceFeatures supported;
+
+	// surface가 있을 때만 (format / present mode는 바뀌지 않는다)
+	std::vector<vk::SurfaceFormatKHR> surfaceFormats;
+	std::vector<vk::PresentModeKHR> presentModes;
+
+	bool suitable{ false };
+	std::string reason;		// suitable이 아닌 이유
+	uint64_t score{ 0 };
+
+	bool hasExtension(const char* name) const;
+};
+
+// requiredExtensions : 없으면 suitable이 아니다
+VEdeviceCapabilities queryDeviceCapabilities(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR surface,
+	const std::vector<const char*>& requiredExtensions);
+uint64_t scoreDevice(const VEdeviceCapabilities& capabilities);
+
+QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice, vk::SurfaceKHR);
+SwapChainSupportDetails querySwapChainSupport(vk::PhysicalDevice, vk::SurfaceKHR);
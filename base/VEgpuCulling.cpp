@@ -0,0 +1,295 @@
+#include "VEgpuCulling.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+	// descriptor template이 읽는 binding 순서 그대로
+	struct DescriptorData {
+		vk::DescriptorBufferInfo objects;
+		vk::DescriptorBufferInfo commands;
+		vk::DescriptorBufferInfo count;
+	};
+}
+
+void VEgpuCuller::init(vk::Device device, VEallocator& allocator, VEpipelineCache& pipelineCache, uint32_t framesInFlight,
+	const std::vector<char>& shaderCode, bool useDrawCount, uint32_t maxDrawCount) {
+	this->device = device;
+	this->allocator = &allocator;
+	this->useDrawCount = useDrawCount;
+	this->maxDrawCount = std::max(maxDrawCount, 1u);
+
+	vk::DescriptorSetLayoutBinding bindings[]{
+		{
+			.binding = 0,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.descriptorCount = 1,
+			.stageFlags = vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eVertex,
+		},
+		{
+			.binding = 1,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.descriptorCount = 1,
+			.stageFlags = vk::ShaderStageFlagBits::eCompute,
+		},
+		{
+			.binding = 2,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.descriptorCount = 1,
+			.stageFlags = vk::ShaderStageFlagBits::eCompute,
+		},
+	};
+
+	setLayout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+		.bindingCount = 3,
+		.pBindings = bindings,
+	});
+
+	descriptorTemplate.init(device, setLayout, {
+		{ .binding = 0, .type = vk::DescriptorType::eStorageBuffer, .offset = offsetof(DescriptorData, objects) },
+		{ .binding = 1, .type = vk::DescriptorType::eStorageBuffer, .offset = offsetof(DescriptorData, commands) },
+		{ .binding = 2, .type = vk::DescriptorType::eStorageBuffer, .offset = offsetof(DescriptorData, count) },
+	});
+
+	// set은 slot 마다 하나씩 한 번만 할당한다
+	descriptorAllocator.init(device, { { vk::DescriptorType::eStorageBuffer, 3.0f } }, framesInFlight, framesInFlight);
+
+	vk::PushConstantRange constantRange{
+		.stageFlags = vk::ShaderStageFlagBits::eCompute,
+		.offset = 0,
+		.size = sizeof(Constants),
+	};
+	pipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+		.setLayoutCount = 1,
+		.pSetLayouts = &setLayout,
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = &constantRange,
+	});
+
+	auto shaderModule = device.createShaderModule(vk::ShaderModuleCreateInfo{
+		.codeSize = shaderCode.size(),
+		.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data()),
+	});
+
+	pipeline = pipelineCache.createComputePipeline(vk::ComputePipelineCreateInfo{
+		.stage = {
+			.stage = vk::ShaderStageFlagBits::eCompute,
+			.module = shaderModule,
+			.pName = "main",
+		},
+		.layout = pipelineLayout,
+	});
+
+	device.destroyShaderModule(shaderModule);
+
+	frames.resize(framesInFlight);
+	for (auto& frame : frames) {
+		frame.count = createBuffer(sizeof(uint32_t),
+			vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eDeviceLocal);
+		frame.readback = createBuffer(sizeof(uint32_t), vk::BufferUsageFlagBits::eTransferDst,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+		memset(frame.readback.allocation.mapped, 0, sizeof(uint32_t));
+
+		frame.descriptorSet = descriptorAllocator.allocate(setLayout);
+	}
+}
+
+// device가 idle 일 때 호출하므로 retire 하지 않고 바로 파괴한다
+void VEgpuCuller::cleanUp() {
+	destroyBuffer(objects);
+	objectCount = 0;
+
+	for (auto& frame : frames) {
+		destroyBuffer(frame.commands);
+		destroyBuffer(frame.count);
+		destroyBuffer(frame.readback);
+	}
+	frames.clear();
+	capacity = 0;
+
+	device.destroyPipeline(pipeline);
+	device.destroyPipelineLayout(pipelineLayout);
+	descriptorTemplate.cleanUp();
+	descriptorAllocator.cleanUp();
+	device.destroyDescriptorSetLayout(setLayout);
+}
+
+void VEgpuCuller::setObjects(VEstagingRing& staging, const std::vector<VEgpuObject>& objects) {
+	retireBuffer(this->objects);
+
+	objectCount = static_cast<uint32_t>(objects.size());
+
+	// 빈 buffer는 만들 수 없으므로 object가 없어도 하나 크기는 잡는다
+	auto size = sizeof(VEgpuObject) * std::max(objectCount, 1u);
+	this->objects = createBuffer(size, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+		vk::MemoryPropertyFlagBits::eDeviceLocal);
+	if (objectCount) {
+		staging.upload(this->objects.buffer, 0, objects.data(), sizeof(VEgpuObject) * objectCount);
+	}
+
+	if (objectCount > capacity) {
+		createCommandBuffers(objectCount);
+	}
+
+	markDirty();
+}
+
+void VEgpuCuller::releaseObjects() {
+	retireBuffer(objects);
+	objectCount = 0;
+
+	markDirty();
+}
+
+void VEgpuCuller::beginFrame(uint32_t frameIndex) {
+	auto& frame = frames[frameIndex];
+	if (!frame.dirty) return;
+
+	// 이 slot의 이전 frame은 끝났으므로 set을 다시 써도 되고, 이전 object의 결과는 버린다
+	memset(frame.readback.allocation.mapped, 0, sizeof(uint32_t));
+
+	// object가 없으면 cull이 set을 bind 하지 않는다
+	if (objects.buffer) {
+		DescriptorData data{
+			.objects = { .buffer = objects.buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+			.commands = { .buffer = frame.commands.buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+			.count = { .buffer = frame.count.buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+		};
+		descriptorTemplate.update(frame.descriptorSet, data);
+	}
+	frame.dirty = false;
+}
+
+void VEgpuCuller::cull(vk::CommandBuffer commandBuffer, uint32_t frameIndex, const VEfrustum& frustum) {
+	auto& frame = frames[frameIndex];
+
+	commandBuffer.fillBuffer(frame.count.buffer, 0, sizeof(uint32_t), 0);
+
+	vk::MemoryBarrier clearBarrier{
+		.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+		.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+	};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+		{}, clearBarrier, nullptr, nullptr);
+
+	Constants constants{
+		.objectCount = objectCount,
+		.compact = isCompact() ? 1u : 0u,
+	};
+	std::copy(std::begin(frustum.planes), std::end(frustum.planes), constants.planes);
+
+	// releaseObjects 뒤에는 set이 파괴될 buffer를 가리킬 수 있으므로 bind 하지 않는다 (count는 0으로 남는다)
+	if (objectCount) {
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+		commandBuffer.pushConstants(pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(constants), &constants);
+		commandBuffer.dispatch((objectCount + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+	}
+
+	// draw command와 count는 indirect 단계에서, count는 readback 복사에서 읽는다
+	vk::MemoryBarrier cullBarrier{
+		.srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+		.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eTransferRead,
+	};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eTransfer, {}, cullBarrier, nullptr, nullptr);
+
+	commandBuffer.copyBuffer(frame.count.buffer, frame.readback.buffer, vk::BufferCopy{ .size = sizeof(uint32_t) });
+
+	vk::MemoryBarrier readbackBarrier{
+		.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+		.dstAccessMask = vk::AccessFlagBits::eHostRead,
+	};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost,
+		{}, readbackBarrier, nullptr, nullptr);
+
+	culledFrames++;
+}
+
+void VEgpuCuller::draw(vk::CommandBuffer commandBuffer, uint32_t frameIndex) {
+	if (objectCount == 0) return;
+
+	auto& frame = frames[frameIndex];
+	constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+
+	if (isCompact()) {
+		commandBuffer.drawIndexedIndirectCount(frame.commands.buffer, 0, frame.count.buffer, 0, objectCount, stride);
+		return;
+	}
+
+	// object 자리마다 command가 있으므로 maxDrawCount 씩 잘라 그린다
+	for (uint32_t first = 0; first < objectCount; first += maxDrawCount) {
+		auto count = std::min(maxDrawCount, objectCount - first);
+		commandBuffer.drawIndexedIndirect(frame.commands.buffer, vk::DeviceSize{ first } * stride, count, stride);
+	}
+}
+
+uint32_t VEgpuCuller::getVisibleCount(uint32_t frameIndex) const {
+	uint32_t count{};
+	memcpy(&count, frames[frameIndex].readback.allocation.mapped, sizeof(count));
+	return count;
+}
+
+void VEgpuCuller::printStats(std::ostream& out) const {
+	out << "gpu culler: " << objectCount << " objects, " << frames.size() << " x " << capacity << " draw commands ("
+		<< (useDrawCount ? "drawIndexedIndirectCount" : "drawIndexedIndirect") << ", max " << maxDrawCount << " per draw), "
+		<< culledFrames << " frames culled\n";
+}
+
+VEgpuCuller::Buffer VEgpuCuller::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties) {
+	Buffer result{};
+
+	result.buffer = device.createBuffer(vk::BufferCreateInfo{
+		.size = size,
+		.usage = usage,
+		.sharingMode = vk::SharingMode::eExclusive,
+	});
+	result.allocation = allocator->allocate(device.getBufferMemoryRequirements(result.buffer), properties);
+	device.bindBufferMemory(result.buffer, result.allocation.memory, result.allocation.offset);
+
+	return result;
+}
+
+void VEgpuCuller::destroyBuffer(Buffer& buffer) {
+	if (!buffer.buffer) return;
+
+	device.destroyBuffer(buffer.buffer);
+	allocator->free(buffer.allocation);
+	buffer = Buffer{};
+}
+
+// 사용중인 frame이 있을 수 있으므로 retire가 설정되어 있으면 넘기고, 아니면 바로 파괴한다
+void VEgpuCuller::retireBuffer(Buffer& buffer) {
+	if (!buffer.buffer) return;
+
+	if (retire) {
+		retire([device = device, allocator = allocator, buffer]() mutable {
+			device.destroyBuffer(buffer.buffer);
+			allocator->free(buffer.allocation);
+		});
+		buffer = Buffer{};
+	}
+	else {
+		destroyBuffer(buffer);
+	}
+}
+
+void VEgpuCuller::createCommandBuffers(uint32_t count) {
+	capacity = count;
+
+	for (auto& frame : frames) {
+		retireBuffer(frame.commands);
+		frame.commands = createBuffer(sizeof(vk::DrawIndexedIndirectCommand) * capacity,
+			vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal);
+	}
+}
+
+void VEgpuCuller::markDirty() {
+	for (auto& frame : frames) {
+		frame.dirty = true;
+	}
+}
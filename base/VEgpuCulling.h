@@ -0,0 +1,136 @@
+#pragma once
+
+#include "VEallocator.h"
+#include "VEculling.h"
+#include "VEdescriptor.h"
+#include "VEdevice.h"
+#include "VEpipelineCache.h"
+#include "VEstaging.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+// ------------- GPU Culling ----------------
+//
+// object 목록 (bounding sphere + index 범위)을 storage buffer에 한 번 올려두고,
+// 매 frame compute shader (shaders/gpuculling/cull.comp)가 frustum과 비교해서 보이는 object의
+// VkDrawIndexedIndirectCommand와 개수를 쓴다. 그리는 쪽은 drawIndexedIndirectCount 한 번이면 된다.
+// CPU가 frame 마다 하는 일은 object 수와 관계없이 fillBuffer + dispatch + draw 한 번씩이다.
+//	- beginFrame(frame)			: VEbase::beginFrame 이후, 바뀐 object buffer로 이 slot의 descriptor set을 다시 쓴다
+//	- cull(cmd, frame, frustum)	: renderpass 밖에서 기록 (count 초기화, dispatch, indirect 단계와의 barrier)
+//	- draw(cmd, frame)			: renderpass 안 (secondary command buffer 가능)에서 기록
+//
+// draw command의 firstInstance는 object 번호이므로 vertex shader는 gl_InstanceIndex로
+// object buffer (set 0, binding 0)의 per-draw data를 읽는다 (drawIndirectFirstInstance 필요).
+// draw command / count buffer는 frame in flight slot 마다 따로 두어 이전 frame의 draw와 겹치지 않는다.
+//
+// drawIndirectCount를 켜지 않은 device에서는 compact 하지 않고 object 자리에 instanceCount 0 / 1을 쓴 뒤
+// drawIndexedIndirect(objectCount)로 그린다 (GPU에서 빈 draw를 건너뛴다).
+// 두 경로 모두 multiDrawIndirect가 필요하다 (isSupported).
+// 한 번에 그릴 수 있는 draw 수는 maxDrawIndirectCount (multiDrawIndirect가 보장하는 값은 65535) 까지이므로,
+// object가 그보다 많으면 compact 하지 않는 경로로 바꾸고 drawIndexedIndirect를 limit 단위로 나눠 기록한다.
+//
+// 보이는 object 수는 host visible buffer로 복사해 둔다. slot의 frame이 GPU에서 끝난 뒤에 읽을 수 있다.
+//
+// setObjects / releaseObjects는 GPU를 기다리지 않는다. 이전 object / draw command buffer는 retire로 넘기고
+// (setRetire, 설정하지 않으면 바로 파괴), descriptor set은 slot 마다 다음 beginFrame에서 다시 쓴다.
+// 그래서 아직 GPU에 남은 frame은 이전 buffer를, 그 뒤에 기록하는 frame은 새 buffer를 읽는다.
+
+// std430 : shaders/gpuculling의 Object와 같은 배치
+struct VEgpuObject {
+	glm::vec4 sphere;		// xyz = 중심, w = 반지름 (cull에 넘기는 frustum과 같은 공간)
+	uint32_t indexCount;
+	uint32_t firstIndex;
+	int32_t vertexOffset;
+	uint32_t padding{ 0 };
+};
+
+class VEgpuCuller {
+public:
+	using RetireFunc = std::function<void(std::function<void()>)>;
+
+	static constexpr uint32_t GROUP_SIZE = 64;	// cull.comp의 local_size_x
+
+	static bool isSupported(const VEdeviceFeatures& enabledFeatures) { return enabledFeatures.multiDrawIndirect; }
+
+	// shaderCode : cull.comp.spv
+	// useDrawCount : drawIndexedIndirectCount 사용 (enabledFeatures.drawIndirectCount)
+	// maxDrawCount : limits.maxDrawIndirectCount
+	void init(vk::Device device, VEallocator& allocator, VEpipelineCache& pipelineCache, uint32_t framesInFlight,
+		const std::vector<char>& shaderCode, bool useDrawCount, uint32_t maxDrawCount);
+	void cleanUp();
+
+	// 설정하면 교체한 buffer의 파괴를 바로 하지 않고 넘겨준다 (사용중인 frame이 끝난 뒤 실행)
+	void setRetire(RetireFunc retire) { this->retire = std::move(retire); }
+
+	// object buffer를 새로 만들고 upload를 기록한다 (flush / waitOnGraphics는 호출한 쪽에서)
+	// frame이 GPU에 남아 있어도 호출할 수 있다 (각 slot은 다음 beginFrame부터 새 object를 쓴다)
+	void setObjects(VEstagingRing& staging, const std::vector<VEgpuObject>& objects);
+	void releaseObjects();
+
+	// 이 slot의 이전 frame이 GPU에서 끝난 뒤 (VEbase::beginFrame 이후), cull / draw 전에 호출
+	void beginFrame(uint32_t frameIndex);
+	void cull(vk::CommandBuffer commandBuffer, uint32_t frameIndex, const VEfrustum& frustum);
+	void draw(vk::CommandBuffer commandBuffer, uint32_t frameIndex);
+
+	// binding 0 (object buffer)은 vertex shader에서도 읽을 수 있다
+	vk::DescriptorSetLayout getSetLayout() const { return setLayout; }
+	vk::DescriptorSet getDescriptorSet(uint32_t frameIndex) const { return frames[frameIndex].descriptorSet; }
+
+	uint32_t getObjectCount() const { return objectCount; }
+	bool usesDrawCount() const { return useDrawCount; }
+	// 이 slot이 마지막으로 cull 한 결과 (slot의 frame이 GPU에서 끝난 뒤에 호출)
+	uint32_t getVisibleCount(uint32_t frameIndex) const;
+
+	void printStats(std::ostream& out) const;
+private:
+	struct Constants {
+		glm::vec4 planes[6];
+		uint32_t objectCount;
+		uint32_t compact;
+	};
+
+	struct Buffer {
+		vk::Buffer buffer;
+		VEallocation allocation;
+	};
+
+	struct Frame {
+		Buffer commands;	// VkDrawIndexedIndirectCommand x capacity
+		Buffer count;		// uint32_t (indirect count)
+		Buffer readback;	// count 복사본 (host visible)
+		vk::DescriptorSet descriptorSet;
+		bool dirty{ false };	// object가 바뀌었다 : beginFrame에서 set을 다시 쓰고 readback을 비운다
+	};
+
+	vk::Device device;
+	VEallocator* allocator{ nullptr };
+	bool useDrawCount{ false };
+	uint32_t maxDrawCount{ 1 };
+	RetireFunc retire;
+
+	vk::DescriptorSetLayout setLayout;
+	VEdescriptorAllocator descriptorAllocator;
+	VEdescriptorTemplate descriptorTemplate;
+	vk::PipelineLayout pipelineLayout;
+	vk::Pipeline pipeline;
+
+	Buffer objects;
+	uint32_t objectCount{ 0 };
+	uint32_t capacity{ 0 };		// frame 별 command buffer에 들어가는 draw 수
+	std::vector<Frame> frames;
+
+	uint64_t culledFrames{ 0 };
+
+	Buffer createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
+	void destroyBuffer(Buffer& buffer);
+	void retireBuffer(Buffer& buffer);
+	void createCommandBuffers(uint32_t count);
+	void markDirty();
+	// drawIndexedIndirectCount 한 번으로 그릴 수 있을 때만 compact 한다
+	bool isCompact() const { return useDrawCount && objectCount <= maxDrawCount; }
+};
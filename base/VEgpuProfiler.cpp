@@ -0,0 +1,158 @@
+#include "VEgpuProfiler.h"
+
+#include <algorithm>
+#include <map>
+
+static constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+static constexpr uint32_t INVALID_ZONE = ~0u;
+
+void VEgpuProfiler::init(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamily, uint32_t framesInFlight, uint32_t maxZones) {
+	this->device = device;
+
+	auto properties = physicalDevice.getProperties();
+	auto validBits = physicalDevice.getQueueFamilyProperties()[queueFamily].timestampValidBits;
+
+	// timestamp를 지원하지 않는 queue면 zone은 아무것도 하지 않는다
+	supported = validBits > 0 && properties.limits.timestampPeriod > 0.0f;
+	if (!supported) return;
+
+	timestampPeriod = properties.limits.timestampPeriod;
+	timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+	maxQueries = maxZones * 2;
+
+	frames.resize(framesInFlight);
+	for (auto& frame : frames) {
+		vk::QueryPoolCreateInfo queryPoolInfo{
+			.queryType = vk::QueryType::eTimestamp,
+			.queryCount = maxQueries,
+		};
+
+		frame.queryPool = device.createQueryPool(queryPoolInfo);
+	}
+}
+
+void VEgpuProfiler::cleanUp() {
+	for (auto& frame : frames) {
+		device.destroyQueryPool(frame.queryPool);
+	}
+	frames.clear();
+	current = nullptr;
+}
+
+void VEgpuProfiler::beginFrame(vk::CommandBuffer commandBuffer, uint32_t frameIndex) {
+	if (!supported) return;
+
+	auto& frame = frames[frameIndex % frames.size()];
+
+	// 이 slot을 마지막으로 쓴 frame은 완료 대기가 끝났으므로 결과가 준비되어 있어야 한다
+	if (frame.recorded) {
+		resolve(frame);
+	}
+
+	commandBuffer.resetQueryPool(frame.queryPool, 0, maxQueries);
+
+	frame.queryCount = 0;
+	frame.zones.clear();
+	frame.cpuTimeUs = traceClockUs();
+	frame.recorded = true;
+
+	current = &frame;
+	depth = 0;
+}
+
+uint32_t VEgpuProfiler::beginZone(vk::CommandBuffer commandBuffer, const std::string& name) {
+	if (!supported || current == nullptr || current->queryCount + 2 > maxQueries) {
+		return INVALID_ZONE;
+	}
+
+	uint32_t beginQuery = current->queryCount;
+	current->queryCount += 2;
+
+	commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, current->queryPool, beginQuery);
+
+	current->zones.push_back(Zone{
+		.name = name,
+		.depth = depth++,
+		.beginQuery = beginQuery,
+		.endQuery = beginQuery + 1,
+	});
+
+	return static_cast<uint32_t>(current->zones.size() - 1);
+}
+
+void VEgpuProfiler::endZone(vk::CommandBuffer commandBuffer, uint32_t zone) {
+	if (zone == INVALID_ZONE || current == nullptr) return;
+
+	commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, current->queryPool, current->zones[zone].endQuery);
+	depth--;
+}
+
+void VEgpuProfiler::resolve(Frame& frame) {
+	frame.recorded = false;
+	if (frame.queryCount == 0) return;
+
+	auto [result, timestamps] = device.getQueryPoolResults<uint64_t>(frame.queryPool, 0, frame.queryCount,
+		frame.queryCount * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+	if (result != vk::Result::eSuccess) return;
+
+	auto toMs = [&](uint64_t ticks) {
+		return static_cast<double>(ticks & timestampMask) * timestampPeriod / 1e6;
+	};
+
+	uint64_t frameBegin = ~0ull;
+	uint64_t frameEnd = 0;
+	for (auto& zone : frame.zones) {
+		frameBegin = std::min(frameBegin, timestamps[zone.beginQuery] & timestampMask);
+		frameEnd = std::max(frameEnd, timestamps[zone.endQuery] & timestampMask);
+	}
+
+	results.clear();
+	for (auto& zone : frame.zones) {
+		auto begin = timestamps[zone.beginQuery] & timestampMask;
+		auto end = timestamps[zone.endQuery] & timestampMask;
+		if (end < begin) continue;	// timestamp wrap-around
+
+		VEgpuZoneResult zoneResult{
+			.name = zone.name,
+			.depth = zone.depth,
+			.startMs = toMs(begin - frameBegin),
+			.durationMs = toMs(end - begin),
+		};
+
+		auto& stats = zoneStats[zone.name];
+		stats.totalMs += zoneResult.durationMs;
+		stats.count++;
+
+		if (capture && traceEvents.size() < MAX_TRACE_EVENTS) {
+			traceEvents.push_back(VEtraceEvent{
+				.name = zone.name,
+				.pid = VE_TRACE_GPU,
+				.tid = 0,
+				.startUs = frame.cpuTimeUs + zoneResult.startMs * 1000.0,
+				.durationUs = zoneResult.durationMs * 1000.0,
+			});
+		}
+
+		results.push_back(std::move(zoneResult));
+	}
+
+	frameTimeMs = frameEnd > frameBegin ? toMs(frameEnd - frameBegin) : 0.0;
+	frameStats.totalMs += frameTimeMs;
+	frameStats.count++;
+}
+
+void VEgpuProfiler::printStats(std::ostream& out) const {
+	if (!supported) {
+		out << "gpu profiler: timestamps not supported\n";
+		return;
+	}
+	if (frameStats.count == 0) return;
+
+	out << "gpu profiler: " << frameStats.count << " frames, " << frameStats.totalMs / frameStats.count << " ms / frame\n";
+
+	std::map<std::string, ZoneStats> sorted(zoneStats.begin(), zoneStats.end());
+	for (auto& [name, stats] : sorted) {
+		out << "\t" << name << " : " << stats.totalMs / stats.count << " ms (" << stats.count << " samples)\n";
+	}
+}
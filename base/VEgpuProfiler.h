@@ -0,0 +1,110 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include "VEtrace.h"
+
+#include <string>
+#include <unordered_map>
+
+// ------------- GPU Profiler ----------------
+//
+// timestamp query로 command buffer 안의 구간(zone) 시간을 잰다.
+// frame in flight 마다 query pool을 따로 두고, beginFrame(frame)에서
+//	1. 같은 slot을 이전에 사용한 frame의 결과를 읽고 (VEbase::beginFrame 대기 후이므로 멈추지 않는다)
+//	2. pool을 reset 한 뒤 새 frame의 zone을 기록한다.
+// 결과가 아직 준비되지 않았으면 (eNotReady) 그 frame은 건너뛴다.
+//
+// GPU timestamp는 CPU 시계와 기준이 다르므로, trace로 내보낼 때는
+// frame 기록 시점의 CPU 시간을 frame 첫 timestamp에 맞춰 정렬한다 (대략적인 위치만 맞춘다).
+
+struct VEgpuZoneResult {
+	std::string name;
+	uint32_t depth;
+	double startMs;		// frame 첫 timestamp 기준
+	double durationMs;
+};
+
+class VEgpuProfiler {
+public:
+	void init(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamily, uint32_t framesInFlight, uint32_t maxZones = 256);
+	void cleanUp();
+
+	bool isSupported() const { return supported; }
+
+	// command buffer 기록 시작 직후 호출
+	void beginFrame(vk::CommandBuffer commandBuffer, uint32_t frameIndex);
+
+	uint32_t beginZone(vk::CommandBuffer commandBuffer, const std::string& name);
+	void endZone(vk::CommandBuffer commandBuffer, uint32_t zone);
+
+	// 가장 최근에 읽어온 frame의 결과
+	const std::vector<VEgpuZoneResult>& getResults() const { return results; }
+	double getFrameTimeMs() const { return frameTimeMs; }
+	// 지금까지 결과를 읽어온 frame 수 (값이 바뀌면 getFrameTimeMs가 새 frame의 값)
+	uint32_t getResolvedFrameCount() const { return frameStats.count; }
+
+	// trace 수집 (기본 꺼짐)
+	void setCapture(bool capture) { this->capture = capture; }
+	const std::vector<VEtraceEvent>& getTraceEvents() const { return traceEvents; }
+
+	void printStats(std::ostream& out) const;
+private:
+	struct Zone {
+		std::string name;
+		uint32_t depth;
+		uint32_t beginQuery;
+		uint32_t endQuery;
+	};
+
+	struct Frame {
+		vk::QueryPool queryPool;
+		uint32_t queryCount{ 0 };
+		std::vector<Zone> zones;
+		double cpuTimeUs{ 0.0 };	// 기록 시작 시점
+		bool recorded{ false };
+	};
+
+	struct ZoneStats {
+		double totalMs{ 0.0 };
+		uint32_t count{ 0 };
+	};
+
+	vk::Device device;
+	bool supported{ false };
+	double timestampPeriod{ 1.0 };	// ns / tick
+	uint64_t timestampMask{ ~0ull };
+	uint32_t maxQueries{ 0 };
+
+	std::vector<Frame> frames;
+	Frame* current{ nullptr };
+	uint32_t depth{ 0 };
+
+	std::vector<VEgpuZoneResult> results;
+	double frameTimeMs{ 0.0 };
+
+	// 이름별 누적 (printStats)
+	std::unordered_map<std::string, ZoneStats> zoneStats;
+	ZoneStats frameStats;
+
+	bool capture{ false };
+	std::vector<VEtraceEvent> traceEvents;
+
+	void resolve(Frame& frame);
+};
+
+// 범위를 벗어날 때 endZone 하는 scoped zone
+class VEgpuZone {
+public:
+	VEgpuZone(VEgpuProfiler& profiler, vk::CommandBuffer commandBuffer, const std::string& name)
+		: profiler(profiler), commandBuffer(commandBuffer), zone(profiler.beginZone(commandBuffer, name)) {}
+	~VEgpuZone() { profiler.endZone(commandBuffer, zone); }
+
+	VEgpuZone(const VEgpuZone&) = delete;
+	VEgpuZone& operator=(const VEgpuZone&) = delete;
+private:
+	VEgpuProfiler& profiler;
+	vk::CommandBuffer commandBuffer;
+	uint32_t zone;
+};
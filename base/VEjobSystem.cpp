@@ -0,0 +1,317 @@
+#include "VEjobSystem.h"
+#include "VEprofiler.h"
+
+#include <algorithm>
+
+struct VEjob {
+	VEjobSystem::JobFunc func;
+	VEjobCounter* counter;
+};
+
+static thread_local uint32_t currentThread = VEjobSystem::INVALID_THREAD;
+
+// ---- Chase-Lev deque ----
+
+bool VEjobDeque::push(VEjob* job) {
+	auto b = bottom.load(std::memory_order_relaxed);
+	auto t = top.load(std::memory_order_acquire);
+	if (b - t >= CAPACITY) return false;
+
+	buffer[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);	// steal이 acquire로 읽어 job 내용을 본다
+	return true;
+}
+
+VEjob* VEjobDeque::pop() {
+	auto b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto t = top.load(std::memory_order_relaxed);
+
+	if (t > b) {
+		// 비어있다
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto job = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (t == b) {
+		// 마지막 하나는 steal과 경쟁한다
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			job = nullptr;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+VEjob* VEjobDeque::steal() {
+	auto t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b) return nullptr;
+
+	auto job = buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return nullptr;
+	}
+
+	return job;
+}
+
+// ---- Job System ----
+
+void VEjobSystem::init(uint32_t threadCount) {
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	uint32_t workerCount = threadCount - 1;
+
+	quit = false;
+	currentThread = 0;
+
+	deques.clear();
+	for (uint32_t i = 0; i < 1 + workerCount + MAX_ATTACHED_THREADS; i++) {
+		deques.push_back(std::make_unique<VEjobDeque>());
+	}
+
+	for (uint32_t i = 1; i <= workerCount; i++) {
+		workers.emplace_back(&VEjobSystem::workerLoop, this, i);
+	}
+}
+
+void VEjobSystem::cleanUp() {
+	{
+		std::lock_guard lock(sleepMutex);
+		quit = true;
+	}
+	wake.notify_all();
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+
+	// 남은 job은 실행하지 않고 버린다 (cleanUp 전에 wait 해야 한다)
+	for (auto& deque : deques) {
+		while (auto job = deque->pop()) delete job;
+	}
+	deques.clear();
+
+	for (auto job : sharedJobs) delete job;
+	sharedJobs.clear();
+
+	pumpMain();
+	currentThread = INVALID_THREAD;
+}
+
+uint32_t VEjobSystem::threadIndex() {
+	return currentThread;
+}
+
+uint32_t VEjobSystem::attachThread() {
+	if (currentThread != INVALID_THREAD) return currentThread;
+
+	auto mask = attachedMask.load();
+	while (true) {
+		uint32_t slot = 0;
+		while (slot < MAX_ATTACHED_THREADS && (mask & (1u << slot))) slot++;
+		if (slot == MAX_ATTACHED_THREADS) return INVALID_THREAD;
+
+		// 실패하면 mask가 최신 값으로 바뀌므로 다시 찾는다
+		if (attachedMask.compare_exchange_weak(mask, mask | (1u << slot))) {
+			currentThread = 1 + getWorkerCount() + slot;
+			return currentThread;
+		}
+	}
+}
+
+void VEjobSystem::detachThread() {
+	if (currentThread == INVALID_THREAD || currentThread <= getWorkerCount()) return;
+
+	// deque에 남은 job은 다른 thread가 실행하도록 공유 queue로 옮긴다
+	auto& deque = *deques[currentThread];
+	{
+		std::lock_guard lock(sharedMutex);
+		while (auto job = deque.pop()) sharedJobs.push_back(job);
+	}
+
+	attachedMask.fetch_and(~(1u << (currentThread - 1 - getWorkerCount())));
+	currentThread = INVALID_THREAD;
+}
+
+void VEjobSystem::run(JobFunc func, VEjobCounter* counter, VEjobCounter* after) {
+	if (counter) {
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto job = new VEjob{
+		.func = std::move(func),
+		.counter = counter,
+	};
+
+	if (after) {
+		std::lock_guard lock(after->mutex);
+		if (after->value.load(std::memory_order_acquire) > 0) {
+			after->waiting.push_back(job);
+			return;
+		}
+	}
+
+	push(job);
+}
+
+void VEjobSystem::push(VEjob* job) {
+	auto thread = currentThread;
+	if (thread == INVALID_THREAD || !deques[thread]->push(job)) {
+		std::lock_guard lock(sharedMutex);
+		sharedJobs.push_back(job);
+	}
+
+	queuedJobs.fetch_add(1);
+	if (sleepers.load() > 0) {
+		{
+			std::lock_guard lock(sleepMutex);
+		}
+		wake.notify_one();
+	}
+}
+
+VEjob* VEjobSystem::findJob(uint32_t thread) {
+	VEjob* job = nullptr;
+
+	if (thread != INVALID_THREAD) {
+		job = deques[thread]->pop();
+	}
+
+	if (!job) {
+		std::lock_guard lock(sharedMutex);
+		if (!sharedJobs.empty()) {
+			job = sharedJobs.front();
+			sharedJobs.pop_front();
+		}
+	}
+
+	// 옆 thread부터 차례로 훔친다
+	auto count = static_cast<uint32_t>(deques.size());
+	for (uint32_t i = 1; !job && i < count; i++) {
+		auto victim = (thread == INVALID_THREAD ? i : thread + i) % count;
+		job = deques[victim]->steal();
+	}
+
+	if (job) {
+		queuedJobs.fetch_sub(1);
+	}
+
+	return job;
+}
+
+void VEjobSystem::execute(VEjob* job) {
+	job->func();
+
+	finish(job->counter);
+	delete job;
+}
+
+void VEjobSystem::finish(VEjobCounter* counter) {
+	if (!counter) return;
+
+	// 0으로 만드는 것과 기다리던 job을 꺼내는 것을 한 lock 안에서 한다
+	// (wait이 끝난 쪽이 counter를 파괴하기 전에 lock을 한번 잡으므로 unlock 이후에는 counter를 건드리지 않는다)
+	std::vector<VEjob*> ready;
+	{
+		std::lock_guard lock(counter->mutex);
+		if (counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			ready.swap(counter->waiting);
+		}
+	}
+
+	// 0이 되었다 : 기다리던 job을 시작한다
+	for (auto job : ready) {
+		push(job);
+	}
+}
+
+void VEjobSystem::wait(VEjobCounter& counter) {
+	VE_PROFILE_FUNCTION();
+
+	auto thread = currentThread;
+
+	while (!counter.isDone()) {
+		// 등록되지 않은 thread는 thread 별 resource를 쓰는 job을 실행하면 안 되므로 양보만 한다
+		auto job = thread != INVALID_THREAD ? findJob(thread) : nullptr;
+		if (job) {
+			execute(job);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	// 마지막 finish가 lock을 놓을 때까지 기다린다 (이후 counter를 파괴해도 된다)
+	std::lock_guard lock(counter.mutex);
+}
+
+void VEjobSystem::parallelFor(uint32_t count, uint32_t grain, const RangeFunc& func) {
+	if (count == 0) return;
+
+	grain = std::max(1u, grain);
+	if (count <= grain) {
+		func(0, count);
+		return;
+	}
+
+	VEjobCounter counter;
+	for (uint32_t first = 0; first < count; first += grain) {
+		auto size = std::min(grain, count - first);
+		run([&func, first, size]() { func(first, size); }, &counter);
+	}
+
+	wait(counter);
+}
+
+void VEjobSystem::runOnMain(JobFunc func) {
+	std::lock_guard lock(mainMutex);
+	mainJobs.push_back(std::move(func));
+}
+
+void VEjobSystem::pumpMain() {
+	std::vector<JobFunc> jobs;
+	{
+		std::lock_guard lock(mainMutex);
+		jobs.swap(mainJobs);
+	}
+
+	for (auto& job : jobs) {
+		job();
+	}
+}
+
+void VEjobSystem::workerLoop(uint32_t thread) {
+	currentThread = thread;
+
+	uint32_t idle = 0;
+	while (!quit.load(std::memory_order_relaxed)) {
+		if (auto job = findJob(thread)) {
+			execute(job);
+			idle = 0;
+			continue;
+		}
+
+		// 잠깐 돌다가 잠든다
+		if (++idle < 64) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock lock(sleepMutex);
+		sleepers.fetch_add(1);
+		wake.wait(lock, [&] { return quit.load() || queuedJobs.load() > 0; });
+		sleepers.fetch_sub(1);
+		idle = 0;
+	}
+
+	currentThread = INVALID_THREAD;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ------------- Job System ----------------
+//
+// worker thread 마다 work-stealing deque (Chase-Lev)를 하나씩 둔다.
+//	- 자기 deque의 bottom에서 push / pop (lock 없음)
+//	- 일이 없으면 다른 thread deque의 top에서 steal (CAS)
+// 모든 worker가 일이 없으면 condition variable로 잠든다 (push 시 깨운다).
+//
+// thread 번호 : 0 = main thread, 1 ~ workerCount = worker, 그 뒤는 attachThread로 등록한 thread
+// (render thread 등). 등록된 thread는 wait 중에 다른 job을 대신 실행한다.
+// 등록되지 않은 thread에서 run 한 job은 공유 queue (mutex)로 들어간다.
+//
+// 의존성은 counter로 표현한다.
+//	- run(job, &counter)			: counter를 1 올리고 job이 끝나면 내린다
+//	- run(job, &counter, &after)	: after가 0이 된 뒤에 시작한다
+//	- wait(counter)					: counter가 0이 될 때까지 다른 job을 실행하며 기다린다
+// counter는 wait이 돌아온 뒤에만 파괴해야 한다 (isDone만 보고 파괴하면 안 된다).
+//
+// window / glfw 호출처럼 main thread에서만 해야 하는 일은 runOnMain으로 넘기고,
+// main loop에서 pumpMain()이 실행한다.
+
+struct VEjob;
+
+class VEjobCounter {
+public:
+	uint32_t get() const { return value.load(std::memory_order_acquire); }
+	bool isDone() const { return get() == 0; }
+private:
+	friend class VEjobSystem;
+
+	std::atomic<uint32_t> value{ 0 };
+
+	// 이 counter가 0이 되기를 기다리는 job
+	std::mutex mutex;
+	std::vector<VEjob*> waiting;
+};
+
+// Chase-Lev work-stealing deque (고정 크기)
+class VEjobDeque {
+public:
+	static constexpr int64_t CAPACITY = 1 << 12;
+
+	// owner thread 전용
+	bool push(VEjob* job);
+	VEjob* pop();
+	// 다른 thread
+	VEjob* steal();
+private:
+	alignas(64) std::atomic<int64_t> top{ 0 };
+	alignas(64) std::atomic<int64_t> bottom{ 0 };
+	std::atomic<VEjob*> buffer[CAPACITY];
+};
+
+class VEjobSystem {
+public:
+	using JobFunc = std::function<void()>;
+	using RangeFunc = std::function<void(uint32_t first, uint32_t count)>;
+
+	static constexpr uint32_t MAX_ATTACHED_THREADS = 4;
+
+	// threadCount : main thread를 포함한 실행 thread 수 (worker는 threadCount - 1개)
+	//				 0 -> hardware thread 수
+	// init을 호출한 thread가 main thread (0번)가 된다
+	void init(uint32_t threadCount = 0);
+	void cleanUp();
+
+	// main + worker + attach 가능한 thread 수 (thread 별 resource 개수)
+	uint32_t getThreadCount() const { return static_cast<uint32_t>(deques.size()); }
+	uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+	// 호출한 thread의 번호 (등록되지 않은 thread는 INVALID_THREAD)
+	static constexpr uint32_t INVALID_THREAD = ~0u;
+	static uint32_t threadIndex();
+	bool isMainThread() const { return threadIndex() == 0; }
+
+	// main / worker가 아닌 thread가 job을 실행하며 기다릴 수 있도록 번호를 받는다 (끝나면 detach)
+	uint32_t attachThread();
+	void detachThread();
+
+	void run(JobFunc func, VEjobCounter* counter = nullptr, VEjobCounter* after = nullptr);
+	void wait(VEjobCounter& counter);
+
+	// [0, count)를 grain 크기로 나눠 병렬로 실행하고 모두 끝날 때까지 기다린다
+	void parallelFor(uint32_t count, uint32_t grain, const RangeFunc& func);
+
+	// main thread에서 실행할 일
+	void runOnMain(JobFunc func);
+	void pumpMain();
+private:
+	std::vector<std::unique_ptr<VEjobDeque>> deques;
+	std::vector<std::thread> workers;
+	std::atomic<bool> quit{ false };
+
+	std::atomic<uint32_t> attachedMask{ 0 };
+
+	// 등록되지 않은 thread에서 들어온 job
+	std::mutex sharedMutex;
+	std::deque<VEjob*> sharedJobs;
+
+	// 잠든 worker 깨우기
+	std::atomic<int64_t> queuedJobs{ 0 };
+	std::atomic<uint32_t> sleepers{ 0 };
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+
+	std::mutex mainMutex;
+	std::vector<JobFunc> mainJobs;
+
+	void push(VEjob* job);
+	VEjob* findJob(uint32_t thread);
+	void execute(VEjob* job);
+	void finish(VEjobCounter* counter);
+	void workerLoop(uint32_t thread);
+};
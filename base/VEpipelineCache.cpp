@@ -0,0 +1,202 @@
+#include "VEpipelineCache.h"
+
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static constexpr uint32_t PIPELINE_CACHE_MAGIC = 0x43504556;	// "VEPC"
+static constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+static constexpr uint64_t MAX_PIPELINE_CACHE_SIZE = 256ull * 1024 * 1024;
+
+// FNV-1a
+static uint64_t checksum(const char* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= static_cast<uint8_t>(data[i]);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+void VEpipelineCache::init(vk::PhysicalDevice physicalDevice, vk::Device device, const std::string& path, bool feedbackSupported) {
+	this->device = device;
+	this->path = path;
+	this->feedbackSupported = feedbackSupported;
+
+	properties = physicalDevice.getProperties();
+
+	auto data = load();
+	stats.loadedBytes = data.size();
+
+	vk::PipelineCacheCreateInfo cacheCI{
+		.initialDataSize = data.size(),
+		.pInitialData = data.empty() ? nullptr : data.data(),
+	};
+
+	cache = device.createPipelineCache(cacheCI);
+}
+
+void VEpipelineCache::cleanUp() {
+	device.destroyPipelineCache(cache);
+}
+
+std::vector<char> VEpipelineCache::load() {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return {};
+	}
+
+	VEpipelineCacheFileHeader header{};
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.magic != PIPELINE_CACHE_MAGIC || header.dataSize > MAX_PIPELINE_CACHE_SIZE) {
+		std::cout << "pipeline cache : not a pipeline cache file, ignored\n";
+		return {};
+	}
+
+	std::vector<char> data(header.dataSize);
+	if (!file.read(data.data(), data.size())) {
+		std::cout << "pipeline cache : truncated file, ignored\n";
+		return {};
+	}
+
+	if (!isCompatible(header, data)) {
+		std::cout << "pipeline cache : incompatible with current device / driver, ignored\n";
+		return {};
+	}
+
+	return data;
+}
+
+bool VEpipelineCache::isCompatible(const VEpipelineCacheFileHeader& header, const std::vector<char>& data) const {
+	if (header.magic != PIPELINE_CACHE_MAGIC || header.version != PIPELINE_CACHE_VERSION) return false;
+
+	// driver version은 blob header에 없으므로 파일 header에서 확인한다
+	if (header.vendorID != properties.vendorID ||
+		header.deviceID != properties.deviceID ||
+		header.driverVersion != properties.driverVersion ||
+		memcmp(header.uuid, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0) {
+		return false;
+	}
+
+	if (checksum(data.data(), data.size()) != header.checksum) return false;
+
+	VkPipelineCacheHeaderVersionOne blobHeader{};
+	if (data.size() < sizeof(blobHeader)) return false;
+	memcpy(&blobHeader, data.data(), sizeof(blobHeader));
+
+	return blobHeader.headerSize >= sizeof(blobHeader) &&
+		blobHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		blobHeader.vendorID == properties.vendorID &&
+		blobHeader.deviceID == properties.deviceID &&
+		memcmp(blobHeader.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+bool VEpipelineCache::save() {
+	auto data = device.getPipelineCacheData(cache);
+
+	VEpipelineCacheFileHeader header{
+		.magic = PIPELINE_CACHE_MAGIC,
+		.version = PIPELINE_CACHE_VERSION,
+		.vendorID = properties.vendorID,
+		.deviceID = properties.deviceID,
+		.driverVersion = properties.driverVersion,
+		.dataSize = data.size(),
+		.checksum = checksum(reinterpret_cast<const char*>(data.data()), data.size()),
+	};
+	memcpy(header.uuid, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+	// 임시 파일에 모두 쓴 뒤 교체한다 (atomic write)
+	auto tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			std::cout << "pipeline cache : failed to open " << tempPath << "\n";
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+		file.flush();
+
+		if (!file) {
+			std::cout << "pipeline cache : failed to write " << tempPath << "\n";
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	if (error) {
+		std::cout << "pipeline cache : failed to replace " << path << " (" << error.message() << ")\n";
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	stats.savedBytes = data.size();
+	return true;
+}
+
+vk::Pipeline VEpipelineCache::createGraphicsPipeline(vk::GraphicsPipelineCreateInfo pipelineCI) {
+	vk::PipelineCreationFeedback feedback{};
+	vk::PipelineCreationFeedbackCreateInfo feedbackCI{
+		.pNext = pipelineCI.pNext,
+		.pPipelineCreationFeedback = &feedback,
+	};
+
+	if (feedbackSupported) {
+		pipelineCI.pNext = &feedbackCI;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	auto pipeline = device.createGraphicsPipeline(cache, pipelineCI).value;
+	auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	recordFeedback(feedback, elapsed);
+
+	return pipeline;
+}
+
+vk::Pipeline VEpipelineCache::createComputePipeline(vk::ComputePipelineCreateInfo pipelineCI) {
+	vk::PipelineCreationFeedback feedback{};
+	vk::PipelineCreationFeedbackCreateInfo feedbackCI{
+		.pNext = pipelineCI.pNext,
+		.pPipelineCreationFeedback = &feedback,
+	};
+
+	if (feedbackSupported) {
+		pipelineCI.pNext = &feedbackCI;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	auto pipeline = device.createComputePipeline(cache, pipelineCI).value;
+	auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	recordFeedback(feedback, elapsed);
+
+	return pipeline;
+}
+
+void VEpipelineCache::recordFeedback(const vk::PipelineCreationFeedback& feedback, double elapsedMs) {
+	stats.creationMs += elapsedMs;
+
+	if (!(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid)) {
+		stats.unknown++;
+	}
+	else if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit) {
+		stats.hits++;
+	}
+	else {
+		stats.misses++;
+	}
+}
+
+void VEpipelineCache::printStats(std::ostream& out) const {
+	out << "pipeline cache: " << stats.hits << " hits, " << stats.misses << " misses";
+	if (stats.unknown) {
+		out << ", " << stats.unknown << " unknown";
+	}
+	out << ", " << stats.creationMs << " ms creating pipelines"
+		<< " (loaded " << stats.loadedBytes << " B, saved " << stats.savedBytes << " B)\n";
+}
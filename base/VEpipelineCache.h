@@ -0,0 +1,68 @@
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.hpp>
+
+#include <string>
+#include <ostream>
+
+// ------------- Pipeline Cache ----------------
+//
+// 실행할 때마다 모든 pipeline을 처음부터 compile 하지 않도록 VkPipelineCache를 파일로 저장한다.
+//
+// 파일 구조 : [VEpipelineCacheFileHeader][vkGetPipelineCacheData blob]
+//	- 파일 header	: vendor / device / driver version / cache UUID, blob 크기와 checksum
+//	- blob header	: VkPipelineCacheHeaderVersionOne (vendor / device / cache UUID)
+// 둘 중 하나라도 현재 device와 맞지 않으면 파일을 버리고 빈 cache로 시작한다.
+// 저장은 임시 파일에 쓴 뒤 rename 하여 중간에 종료되어도 깨진 파일이 남지 않도록 한다.
+//
+// pipeline 생성 시 VK_EXT_pipeline_creation_feedback이 있으면 cache hit / miss를 집계한다.
+
+struct VEpipelineCacheStats {
+	uint32_t hits{ 0 };
+	uint32_t misses{ 0 };
+	uint32_t unknown{ 0 };		// feedback extension이 없어 확인할 수 없는 경우
+	double creationMs{ 0.0 };	// pipeline 생성에 걸린 전체 시간
+
+	size_t loadedBytes{ 0 };
+	size_t savedBytes{ 0 };
+};
+
+class VEpipelineCache {
+public:
+	void init(vk::PhysicalDevice physicalDevice, vk::Device device, const std::string& path, bool feedbackSupported);
+	void cleanUp();
+
+	bool save();
+
+	vk::Pipeline createGraphicsPipeline(vk::GraphicsPipelineCreateInfo pipelineCI);
+	vk::Pipeline createComputePipeline(vk::ComputePipelineCreateInfo pipelineCI);
+
+	operator vk::PipelineCache() const { return cache; }
+
+	const VEpipelineCacheStats& getStats() const { return stats; }
+	void printStats(std::ostream& out) const;
+private:
+	struct VEpipelineCacheFileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint32_t driverVersion;
+		uint8_t uuid[VK_UUID_SIZE];
+		uint64_t dataSize;
+		uint64_t checksum;
+	};
+
+	vk::Device device;
+	vk::PhysicalDeviceProperties properties;
+	vk::PipelineCache cache;
+	std::string path;
+	bool feedbackSupported{ false };
+
+	VEpipelineCacheStats stats{};
+
+	std::vector<char> load();
+	bool isCompatible(const VEpipelineCacheFileHeader& header, const std::vector<char>& data) const;
+	void recordFeedback(const vk::PipelineCreationFeedback& feedback, double elapsedMs);
+};
@@ -0,0 +1,51 @@
+#include "VEprofiler.h"
+
+static constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+VEprofiler& VEprofiler::get() {
+	static VEprofiler profiler;
+	return profiler;
+}
+
+VEprofilerRing* VEprofiler::registerThread() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	rings.push_back(std::make_unique<VEprofilerRing>(static_cast<uint32_t>(rings.size())));
+	return rings.back().get();
+}
+
+void VEprofiler::collect() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto& ring : rings) {
+		ring->drain([&](const VEcpuZoneRecord& record) {
+			if (events.size() >= MAX_TRACE_EVENTS) return;
+
+			auto begin = traceTicksToUs(record.begin);
+			events.push_back(VEtraceEvent{
+				.name = record.name,
+				.pid = VE_TRACE_CPU,
+				.tid = ring->threadId,
+				.startUs = begin,
+				.durationUs = traceTicksToUs(record.end) - begin,
+			});
+		});
+	}
+}
+
+std::vector<VEtraceEvent> VEprofiler::getTraceEvents() {
+	collect();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return events;
+}
+
+uint64_t VEprofiler::getDroppedCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint64_t dropped = 0;
+	for (auto& ring : rings) {
+		dropped += ring->dropped.load(std::memory_order_relaxed);
+	}
+	return dropped;
+}
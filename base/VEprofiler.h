@@ -0,0 +1,115 @@
+#pragma once
+
+#include "VEtrace.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+// ------------- CPU Profiler ----------------
+//
+//	VE_PROFILE_ZONE("name")	: 현재 scope의 시작 ~ 끝 시간을 기록
+//	VE_PROFILE_FUNCTION()	: 함수 이름으로 zone 기록
+//	VE_PROFILE_FRAME()		: 모든 thread의 ring을 비워 event로 모은다 (frame 마다 한번)
+// VE_ENABLE_PROFILER가 정의되지 않으면 (cmake -DVE_ENABLE_PROFILER=ON) macro는 아무 코드도 만들지 않는다.
+//
+// 각 thread는 자기 ring buffer에만 쓰고 (single producer), collect()가 읽어간다 (single consumer).
+// 기록 쪽은 lock 없이 timestamp 두 번 + ring 쓰기만 한다. ring이 가득 차면 zone을 버린다.
+// zone 이름은 문자열 상수처럼 프로그램이 끝날 때까지 유효한 포인터여야 한다.
+
+struct VEcpuZoneRecord {
+	const char* name;
+	int64_t begin;	// steady_clock tick
+	int64_t end;
+};
+
+class VEprofilerRing {
+public:
+	static constexpr uint32_t CAPACITY = 1 << 14;
+
+	explicit VEprofilerRing(uint32_t threadId) : threadId(threadId) {}
+
+	// 기록 thread 전용
+	bool push(const VEcpuZoneRecord& record) {
+		auto h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		records[h & (CAPACITY - 1)] = record;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	// collect 전용
+	template <typename F>
+	void drain(F&& func) {
+		auto t = tail.load(std::memory_order_relaxed);
+		auto h = head.load(std::memory_order_acquire);
+
+		for (; t != h; t++) {
+			func(records[t & (CAPACITY - 1)]);
+		}
+
+		tail.store(t, std::memory_order_release);
+	}
+
+	const uint32_t threadId;
+	std::atomic<uint64_t> dropped{ 0 };
+private:
+	alignas(64) std::atomic<uint64_t> head{ 0 };
+	alignas(64) std::atomic<uint64_t> tail{ 0 };
+	VEcpuZoneRecord records[CAPACITY];
+};
+
+class VEprofiler {
+public:
+	static VEprofiler& get();
+
+	static int64_t now() {
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+	}
+
+	// 호출한 thread의 ring (처음 호출 시 등록)
+	static VEprofilerRing& threadRing() {
+		thread_local VEprofilerRing* ring = get().registerThread();
+		return *ring;
+	}
+
+	void collect();
+
+	std::vector<VEtraceEvent> getTraceEvents();
+	uint64_t getDroppedCount();
+private:
+	std::mutex mutex;
+	std::vector<std::unique_ptr<VEprofilerRing>> rings;
+	std::vector<VEtraceEvent> events;
+
+	VEprofilerRing* registerThread();
+};
+
+class VEcpuZone {
+public:
+	explicit VEcpuZone(const char* name) : name(name), begin(VEprofiler::now()) {}
+	~VEcpuZone() { VEprofiler::threadRing().push({ name, begin, VEprofiler::now() }); }
+
+	VEcpuZone(const VEcpuZone&) = delete;
+	VEcpuZone& operator=(const VEcpuZone&) = delete;
+private:
+	const char* name;
+	int64_t begin;
+};
+
+#ifdef VE_ENABLE_PROFILER
+#define VE_PROFILE_CONCAT_(a, b) a##b
+#define VE_PROFILE_CONCAT(a, b) VE_PROFILE_CONCAT_(a, b)
+#define VE_PROFILE_ZONE(name) VEcpuZone VE_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define VE_PROFILE_FUNCTION() VE_PROFILE_ZONE(__func__)
+#define VE_PROFILE_FRAME() VEprofiler::get().collect()
+#else
+#define VE_PROFILE_ZONE(name) ((void)0)
+#define VE_PROFILE_FUNCTION() ((void)0)
+#define VE_PROFILE_FRAME() ((void)0)
+#endif
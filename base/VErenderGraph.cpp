@@ -0,0 +1,642 @@
+#include "VErenderGraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+// 다른 pass(또는 이전 frame, 같은 메모리를 쓰던 다른 image)가 attachment / sampling으로 쓰던 image를
+// 처음 사용할 때의 src scope. 내용은 버리므로 layout은 Undefined
+static constexpr vk::PipelineStageFlags TRANSIENT_SRC_STAGES =
+	vk::PipelineStageFlagBits::eColorAttachmentOutput |
+	vk::PipelineStageFlagBits::eEarlyFragmentTests |
+	vk::PipelineStageFlagBits::eLateFragmentTests |
+	vk::PipelineStageFlagBits::eFragmentShader;
+
+static constexpr vk::AccessFlags TRANSIENT_SRC_ACCESS =
+	vk::AccessFlagBits::eColorAttachmentWrite |
+	vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+
+static bool isWrite(VEgraphAccess type) {
+	return type == VEgraphAccess::eColorWrite || type == VEgraphAccess::eDepthWrite;
+}
+
+static bool isDepth(VEgraphAccess type) {
+	return type == VEgraphAccess::eDepthWrite || type == VEgraphAccess::eDepthRead;
+}
+
+static bool isDepthFormat(vk::Format format) {
+	switch (format) {
+	case vk::Format::eD16Unorm:
+	case vk::Format::eX8D24UnormPack32:
+	case vk::Format::eD32Sfloat:
+	case vk::Format::eD16UnormS8Uint:
+	case vk::Format::eD24UnormS8Uint:
+	case vk::Format::eD32SfloatS8Uint:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static vk::ImageAspectFlags getAspect(vk::Format format) {
+	switch (format) {
+	case vk::Format::eD16UnormS8Uint:
+	case vk::Format::eD24UnormS8Uint:
+	case vk::Format::eD32SfloatS8Uint:
+		return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+	default:
+		return isDepthFormat(format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+	}
+}
+
+// access 종류별로 pass 안에서 image가 있어야 할 상태
+static auto getRequiredState(VEgraphAccess type, bool load) {
+	struct {
+		vk::ImageLayout layout;
+		vk::PipelineStageFlags stage;
+		vk::AccessFlags access;
+	} state{};
+
+	switch (type) {
+	case VEgraphAccess::eColorWrite:
+		state.layout = vk::ImageLayout::eColorAttachmentOptimal;
+		state.stage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		state.access = vk::AccessFlagBits::eColorAttachmentWrite;
+		if (load) state.access |= vk::AccessFlagBits::eColorAttachmentRead;
+		break;
+	case VEgraphAccess::eDepthWrite:
+		state.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		state.stage = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+		state.access = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		if (load) state.access |= vk::AccessFlagBits::eDepthStencilAttachmentRead;
+		break;
+	case VEgraphAccess::eDepthRead:
+		state.layout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+		state.stage = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+		state.access = vk::AccessFlagBits::eDepthStencilAttachmentRead;
+		break;
+	case VEgraphAccess::eSampled:
+		state.layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+		state.stage = vk::PipelineStageFlagBits::eFragmentShader;
+		state.access = vk::AccessFlagBits::eShaderRead;
+		break;
+	}
+
+	return state;
+}
+
+void VErenderGraph::init(vk::Device device, VEallocator& allocator, VEgpuProfiler* profiler) {
+	this->device = device;
+	this->allocator = &allocator;
+	this->profiler = profiler;
+}
+
+void VErenderGraph::cleanUp() {
+	releaseTargets();
+
+	for (auto& pass : passes) {
+		if (pass.renderPass) {
+			device.destroyRenderPass(pass.renderPass);
+		}
+	}
+
+	passes.clear();
+	resources.clear();
+	finalBarriers.clear();
+	backbuffer = ~0u;
+}
+
+uint32_t VErenderGraph::importBackbuffer(const std::string& name, vk::Format format, vk::ImageLayout finalLayout) {
+	if (backbuffer != ~0u) {
+		throw std::runtime_error("render graph : backbuffer already imported");
+	}
+
+	backbuffer = static_cast<uint32_t>(resources.size());
+	resources.push_back(Resource{
+		.name = name,
+		.desc = { .format = format },
+		.imported = true,
+		.output = true,
+		.finalLayout = finalLayout,
+	});
+
+	return backbuffer;
+}
+
+uint32_t VErenderGraph::createImage(const std::string& name, const VEgraphImageDesc& desc) {
+	resources.push_back(Resource{
+		.name = name,
+		.desc = desc,
+	});
+
+	return static_cast<uint32_t>(resources.size() - 1);
+}
+
+void VErenderGraph::markOutput(uint32_t resource) {
+	resources[resource].output = true;
+}
+
+uint32_t VErenderGraph::addPass(const std::string& name, RecordFunc record) {
+	passes.push_back(Pass{
+		.name = name,
+		.record = std::move(record),
+	});
+
+	return static_cast<uint32_t>(passes.size() - 1);
+}
+
+uint32_t VErenderGraph::addParallelPass(const std::string& name, ParallelRecordFunc record) {
+	passes.push_back(Pass{
+		.name = name,
+		.parallelRecord = std::move(record),
+	});
+
+	return static_cast<uint32_t>(passes.size() - 1);
+}
+
+void VErenderGraph::writeColor(uint32_t pass, uint32_t resource, std::optional<vk::ClearValue> clear) {
+	passes[pass].accesses.push_back({ resource, VEgraphAccess::eColorWrite, clear });
+}
+
+void VErenderGraph::writeDepth(uint32_t pass, uint32_t resource, std::optional<vk::ClearValue> clear) {
+	passes[pass].accesses.push_back({ resource, VEgraphAccess::eDepthWrite, clear });
+}
+
+void VErenderGraph::readDepth(uint32_t pass, uint32_t resource) {
+	passes[pass].accesses.push_back({ resource, VEgraphAccess::eDepthRead });
+}
+
+void VErenderGraph::readTexture(uint32_t pass, uint32_t resource) {
+	passes[pass].accesses.push_back({ resource, VEgraphAccess::eSampled });
+}
+
+void VErenderGraph::compile() {
+	cullPasses();
+	computeBarriers();
+	createRenderPasses();
+}
+
+// 뒤에서부터 훑으며 필요한 resource를 쓰는 pass만 남긴다
+// pass는 선언 순서대로 실행되므로 한번만 훑으면 된다
+void VErenderGraph::cullPasses() {
+	std::vector<bool> needed(resources.size(), false);
+	for (size_t i = 0; i < resources.size(); i++) {
+		needed[i] = resources[i].output;
+	}
+
+	for (auto it = passes.rbegin(); it != passes.rend(); ++it) {
+		auto& pass = *it;
+
+		pass.active = std::any_of(pass.accesses.begin(), pass.accesses.end(), [&](const Access& access) {
+			return isWrite(access.type) && needed[access.resource];
+		});
+
+		if (!pass.active) continue;
+
+		// clear로 덮어쓰는 resource는 이전 pass의 결과가 필요없다
+		for (auto& access : pass.accesses) {
+			needed[access.resource] = !isWrite(access.type) || access.clear == std::nullopt;
+		}
+	}
+
+	// 살아남은 pass 기준으로 usage와 사용 구간을 정한다
+	for (auto& resource : resources) {
+		resource.usage = {};
+		resource.firstPass = -1;
+		resource.lastPass = -1;
+	}
+
+	for (int i = 0; i < static_cast<int>(passes.size()); i++) {
+		auto& pass = passes[i];
+		pass.usesBackbuffer = false;
+		if (!pass.active) continue;
+
+		for (auto& access : pass.accesses) {
+			auto& resource = resources[access.resource];
+
+			switch (access.type) {
+			case VEgraphAccess::eColorWrite:
+				resource.usage |= vk::ImageUsageFlagBits::eColorAttachment;
+				break;
+			case VEgraphAccess::eDepthWrite:
+			case VEgraphAccess::eDepthRead:
+				resource.usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
+				break;
+			case VEgraphAccess::eSampled:
+				resource.usage |= vk::ImageUsageFlagBits::eSampled;
+				break;
+			}
+
+			if (resource.firstPass < 0) resource.firstPass = i;
+			resource.lastPass = i;
+
+			if (access.resource == backbuffer) pass.usesBackbuffer = true;
+		}
+	}
+}
+
+// pass 순서대로 image 상태를 따라가며 필요한 barrier를 만든다
+void VErenderGraph::computeBarriers() {
+	std::vector<ImageState> states(resources.size());
+	for (size_t i = 0; i < resources.size(); i++) {
+		// backbuffer는 acquire semaphore 대기 stage(eColorAttachmentOutput)와 연결한다
+		states[i] = ImageState{
+			.layout = vk::ImageLayout::eUndefined,
+			.stage = i == backbuffer ? vk::PipelineStageFlags{ vk::PipelineStageFlagBits::eColorAttachmentOutput } : TRANSIENT_SRC_STAGES,
+			.access = i == backbuffer ? vk::AccessFlags{} : TRANSIENT_SRC_ACCESS,
+		};
+	}
+
+	for (auto& pass : passes) {
+		pass.barriers.clear();
+		if (!pass.active) continue;
+
+		for (auto& access : pass.accesses) {
+			auto& current = states[access.resource];
+			bool load = current.layout != vk::ImageLayout::eUndefined && access.clear == std::nullopt;
+			auto required = getRequiredState(access.type, load);
+
+			bool hazard = current.layout != required.layout ||
+				isWrite(access.type) ||
+				(current.access & (vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite));
+
+			if (hazard) {
+				pass.barriers.push_back(Barrier{
+					.resource = access.resource,
+					.src = current,
+					.dst = { required.layout, required.stage, required.access },
+				});
+			}
+
+			current = { required.layout, required.stage, required.access };
+		}
+	}
+
+	// 외부로 내보낼 layout (present / transfer src)
+	finalBarriers.clear();
+	for (uint32_t i = 0; i < resources.size(); i++) {
+		auto& resource = resources[i];
+		if (!resource.imported || resource.firstPass < 0) continue;
+
+		finalBarriers.push_back(Barrier{
+			.resource = i,
+			.src = states[i],
+			.dst = { resource.finalLayout, vk::PipelineStageFlagBits::eBottomOfPipe, {} },
+		});
+	}
+}
+
+// pass 하나 = subpass 하나짜리 renderpass
+// layout transition은 barrier에서 끝나므로 initialLayout == finalLayout == subpass layout
+void VErenderGraph::createRenderPasses() {
+	for (int i = 0; i < static_cast<int>(passes.size()); i++) {
+		auto& pass = passes[i];
+		if (pass.renderPass) {
+			device.destroyRenderPass(pass.renderPass);
+			pass.renderPass = nullptr;
+		}
+		pass.clearValues.clear();
+
+		if (!pass.active) continue;
+
+		std::vector<vk::AttachmentDescription> attachments;
+		std::vector<vk::AttachmentReference> colorRefs;
+		std::optional<vk::AttachmentReference> depthRef;
+
+		for (auto& access : pass.accesses) {
+			if (access.type == VEgraphAccess::eSampled) continue;
+
+			auto& resource = resources[access.resource];
+
+			// 이 pass 이후에 읽히거나 외부로 나가는 경우에만 저장한다
+			bool store = resource.output || resource.lastPass > i || access.type == VEgraphAccess::eDepthRead;
+			bool first = resource.firstPass == i;
+
+			vk::AttachmentLoadOp loadOp = access.clear ? vk::AttachmentLoadOp::eClear :
+				first ? vk::AttachmentLoadOp::eDontCare : vk::AttachmentLoadOp::eLoad;
+			vk::AttachmentStoreOp storeOp = store ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+
+			auto layout = getRequiredState(access.type, false).layout;
+			bool hasStencil = static_cast<bool>(getAspect(resource.desc.format) & vk::ImageAspectFlagBits::eStencil);
+
+			vk::AttachmentReference ref{
+				.attachment = static_cast<uint32_t>(attachments.size()),
+				.layout = layout,
+			};
+
+			attachments.push_back(vk::AttachmentDescription{
+				.format = resource.desc.format,
+				.samples = vk::SampleCountFlagBits::e1,
+				.loadOp = loadOp,
+				.storeOp = storeOp,
+				.stencilLoadOp = hasStencil ? loadOp : vk::AttachmentLoadOp::eDontCare,
+				.stencilStoreOp = hasStencil ? storeOp : vk::AttachmentStoreOp::eDontCare,
+				.initialLayout = layout,
+				.finalLayout = layout,
+			});
+
+			pass.clearValues.push_back(access.clear.value_or(vk::ClearValue{}));
+
+			if (isDepth(access.type)) {
+				depthRef = ref;
+			}
+			else {
+				colorRefs.push_back(ref);
+			}
+		}
+
+		vk::SubpassDescription subpass{
+			.pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+			.colorAttachmentCount = static_cast<uint32_t>(colorRefs.size()),
+			.pColorAttachments = colorRefs.data(),
+			.pDepthStencilAttachment = depthRef ? &depthRef.value() : nullptr,
+		};
+
+		vk::RenderPassCreateInfo renderPassInfo{
+			.attachmentCount = static_cast<uint32_t>(attachments.size()),
+			.pAttachments = attachments.data(),
+			.subpassCount = 1,
+			.pSubpasses = &subpass,
+		};
+
+		pass.renderPass = device.createRenderPass(renderPassInfo);
+	}
+}
+
+void VErenderGraph::setBackbuffer(const std::vector<vk::Image>& images, const std::vector<vk::ImageView>& views, vk::Extent2D extent) {
+	releaseTargets();
+
+	backbufferImages = images;
+	backbufferViews = views;
+	this->extent = extent;
+
+	createTransientImages();
+	createFramebuffers();
+}
+
+void VErenderGraph::releaseTargets() {
+	std::vector<vk::Framebuffer> framebuffers;
+	std::vector<vk::ImageView> views;
+	std::vector<vk::Image> images;
+	std::vector<VEallocation> allocations;
+
+	for (auto& pass : passes) {
+		framebuffers.insert(framebuffers.end(), pass.framebuffers.begin(), pass.framebuffers.end());
+		pass.framebuffers.clear();
+	}
+
+	for (auto& resource : resources) {
+		if (resource.imported) continue;
+
+		if (resource.view) views.push_back(resource.view);
+		if (resource.image) images.push_back(resource.image);
+		resource.view = nullptr;
+		resource.image = nullptr;
+	}
+
+	for (auto& slot : slots) {
+		allocations.push_back(slot.allocation);
+	}
+	slots.clear();
+
+	if (!framebuffers.empty() || !images.empty()) {
+		auto destroy = [device = device, allocator = allocator, framebuffers = std::move(framebuffers),
+			views = std::move(views), images = std::move(images), allocations = std::move(allocations)]() mutable {
+			for (auto framebuffer : framebuffers) device.destroyFramebuffer(framebuffer);
+			for (auto view : views) device.destroyImageView(view);
+			for (auto image : images) device.destroyImage(image);
+			for (auto& allocation : allocations) allocator->free(allocation);
+		};
+
+		if (retire) retire(std::move(destroy));
+		else destroy();
+	}
+
+	backbufferImages.clear();
+	backbufferViews.clear();
+	transientBytes = 0;
+	aliasedBytes = 0;
+}
+
+// 사용 구간이 겹치지 않는 image끼리 메모리 slot을 공유한다 (첫 사용 pass 순으로 greedy 배치)
+void VErenderGraph::createTransientImages() {
+	std::vector<uint32_t> order;
+	for (uint32_t i = 0; i < resources.size(); i++) {
+		if (!resources[i].imported && resources[i].firstPass >= 0) {
+			order.push_back(i);
+		}
+	}
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return resources[a].firstPass < resources[b].firstPass;
+	});
+
+	std::vector<uint32_t> slotOf(resources.size());
+
+	for (auto index : order) {
+		auto& resource = resources[index];
+		auto size = getImageExtent(index);
+
+		vk::ImageCreateInfo imageInfo{
+			.imageType = vk::ImageType::e2D,
+			.format = resource.desc.format,
+			.extent = {
+				.width = size.width,
+				.height = size.height,
+				.depth = 1,
+			},
+			.mipLevels = 1,
+			.arrayLayers = 1,
+			.samples = vk::SampleCountFlagBits::e1,
+			.tiling = vk::ImageTiling::eOptimal,
+			.usage = resource.usage,
+			.sharingMode = vk::SharingMode::eExclusive,
+			.initialLayout = vk::ImageLayout::eUndefined,
+		};
+
+		resource.image = device.createImage(imageInfo);
+
+		auto requirements = device.getImageMemoryRequirements(resource.image);
+		transientBytes += requirements.size;
+
+		auto slot = std::find_if(slots.begin(), slots.end(), [&](const MemorySlot& slot) {
+			return slot.lastPass < resource.firstPass && (slot.requirements.memoryTypeBits & requirements.memoryTypeBits);
+		});
+
+		if (slot == slots.end()) {
+			slots.push_back(MemorySlot{
+				.requirements = requirements,
+				.lastPass = resource.lastPass,
+			});
+			slotOf[index] = static_cast<uint32_t>(slots.size() - 1);
+		}
+		else {
+			slot->requirements.size = std::max(slot->requirements.size, requirements.size);
+			slot->requirements.alignment = std::max(slot->requirements.alignment, requirements.alignment);
+			slot->requirements.memoryTypeBits &= requirements.memoryTypeBits;
+			slot->lastPass = resource.lastPass;
+			slotOf[index] = static_cast<uint32_t>(slot - slots.begin());
+		}
+	}
+
+	for (auto& slot : slots) {
+		slot.allocation = allocator->allocate(slot.requirements, vk::MemoryPropertyFlagBits::eDeviceLocal, false);
+		aliasedBytes += slot.requirements.size;
+	}
+
+	for (auto index : order) {
+		auto& resource = resources[index];
+		auto& allocation = slots[slotOf[index]].allocation;
+
+		device.bindImageMemory(resource.image, allocation.memory, allocation.offset);
+
+		vk::ImageViewCreateInfo viewInfo{
+			.image = resource.image,
+			.viewType = vk::ImageViewType::e2D,
+			.format = resource.desc.format,
+			.subresourceRange = {
+				.aspectMask = getAspect(resource.desc.format),
+				.baseMipLevel = 0,
+				.levelCount = 1,
+				.baseArrayLayer = 0,
+				.layerCount = 1,
+			},
+		};
+
+		resource.view = device.createImageView(viewInfo);
+	}
+}
+
+void VErenderGraph::createFramebuffers() {
+	for (auto& pass : passes) {
+		if (!pass.active) continue;
+
+		// framebuffer는 attachment 보다 클 수 없고, 작으면 render area 밖이 잘린다 : 크기가 다르면 거부한다
+		pass.extent = vk::Extent2D{};
+		for (auto& access : pass.accesses) {
+			if (access.type == VEgraphAccess::eSampled) continue;
+
+			auto size = getImageExtent(access.resource);
+			if (!pass.extent.width) {
+				pass.extent = size;
+			}
+			else if (size != pass.extent) {
+				throw std::runtime_error("render graph : attachments of pass " + pass.name + " have different sizes");
+			}
+		}
+		if (!pass.extent.width) pass.extent = extent;
+
+		auto count = pass.usesBackbuffer ? backbufferViews.size() : 1;
+		pass.framebuffers.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			std::vector<vk::ImageView> attachments;
+			for (auto& access : pass.accesses) {
+				if (access.type == VEgraphAccess::eSampled) continue;
+
+				attachments.push_back(access.resource == backbuffer ? backbufferViews[i] : resources[access.resource].view);
+			}
+
+			vk::FramebufferCreateInfo framebufferInfo{
+				.renderPass = pass.renderPass,
+				.attachmentCount = static_cast<uint32_t>(attachments.size()),
+				.pAttachments = attachments.data(),
+				.width = pass.extent.width,
+				.height = pass.extent.height,
+				.layers = 1,
+			};
+
+			pass.framebuffers[i] = device.createFramebuffer(framebufferInfo);
+		}
+	}
+}
+
+vk::Image VErenderGraph::resolveImage(uint32_t resource, uint32_t imageIndex) const {
+	return resource == backbuffer ? backbufferImages[imageIndex] : resources[resource].image;
+}
+
+// desc.extent가 0이면 backbuffer 크기
+vk::Extent2D VErenderGraph::getImageExtent(uint32_t resource) const {
+	auto& desc = resources[resource].desc;
+	return resource != backbuffer && desc.extent.width ? desc.extent : extent;
+}
+
+void VErenderGraph::execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) {
+	auto recordBarriers = [&](const std::vector<Barrier>& barriers) {
+		if (barriers.empty()) return;
+
+		std::vector<vk::ImageMemoryBarrier> imageBarriers;
+		vk::PipelineStageFlags srcStages{};
+		vk::PipelineStageFlags dstStages{};
+
+		for (auto& barrier : barriers) {
+			imageBarriers.push_back(vk::ImageMemoryBarrier{
+				.srcAccessMask = barrier.src.access,
+				.dstAccessMask = barrier.dst.access,
+				.oldLayout = barrier.src.layout,
+				.newLayout = barrier.dst.layout,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = resolveImage(barrier.resource, imageIndex),
+				.subresourceRange = {
+					.aspectMask = getAspect(resources[barrier.resource].desc.format),
+					.baseMipLevel = 0,
+					.levelCount = 1,
+					.baseArrayLayer = 0,
+					.layerCount = 1,
+				},
+			});
+
+			srcStages |= barrier.src.stage;
+			dstStages |= barrier.dst.stage;
+		}
+
+		commandBuffer.pipelineBarrier(srcStages, dstStages, {}, nullptr, nullptr, imageBarriers);
+	};
+
+	for (auto& pass : passes) {
+		if (!pass.active) continue;
+
+		auto zone = profiler ? profiler->beginZone(commandBuffer, pass.name) : 0;
+
+		recordBarriers(pass.barriers);
+
+		vk::RenderPassBeginInfo renderPassInfo{
+			.renderPass = pass.renderPass,
+			.framebuffer = pass.framebuffers[pass.usesBackbuffer ? imageIndex : 0],
+			.renderArea = {
+				.offset = {0, 0},
+				.extent = pass.extent,
+			},
+			.clearValueCount = static_cast<uint32_t>(pass.clearValues.size()),
+			.pClearValues = pass.clearValues.data(),
+		};
+
+		if (pass.parallelRecord) {
+			vk::CommandBufferInheritanceInfo inheritance{
+				.renderPass = pass.renderPass,
+				.subpass = 0,
+				.framebuffer = renderPassInfo.framebuffer,
+			};
+
+			commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+			pass.parallelRecord(commandBuffer, inheritance);
+		}
+		else {
+			commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+			pass.record(commandBuffer);
+		}
+		commandBuffer.endRenderPass();
+
+		if (profiler) profiler->endZone(commandBuffer, zone);
+	}
+
+	recordBarriers(finalBarriers);
+}
+
+void VErenderGraph::printStats(std::ostream& out) const {
+	auto active = std::count_if(passes.begin(), passes.end(), [](const Pass& pass) { return pass.active; });
+
+	out << "render graph: " << active << " / " << passes.size() << " passes active, transient memory "
+		<< transientBytes / 1024 << " KB -> " << aliasedBytes / 1024 << " KB aliased ("
+		<< slots.size() << " slots)\n";
+}
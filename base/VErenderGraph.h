@@ -0,0 +1,164 @@
+#pragma once
+
+#include "VEallocator.h"
+#include "VEgpuProfiler.h"
+
+#include <functional>
+#include <optional>
+#include <string>
+
+// ------------- Render Graph ----------------
+//
+// pass 마다 어떤 image를 읽고 쓰는지 선언하면 compile() 에서
+//	- 최종 출력(backbuffer, markOutput)에 기여하지 않는 pass를 제거 (culling)
+//	- pass 사이의 layout transition / pipeline barrier 계산
+//	- pass 별 renderpass 생성 (attachment load / store op 포함)
+// setBackbuffer() 에서 크기에 의존하는 transient image와 framebuffer를 만든다.
+// pass의 framebuffer / render area 크기는 attachment 크기이며, 한 pass의 attachment는 모두 같은 크기여야 한다.
+// 사용 구간(첫 pass ~ 마지막 pass)이 겹치지 않는 transient image는 같은 메모리를 공유한다 (aliasing).
+//
+// pass는 선언한 순서대로 실행된다. renderpass 안에서의 layout 변화는 없고,
+// 모든 transition은 pass 앞에 pipeline barrier로 기록된다.
+// profiler가 주어지면 pass 마다 GPU zone을 기록한다.
+//
+// addParallelPass로 만든 pass는 renderpass를 secondary command buffer 용으로 시작하고
+// inheritance 정보를 넘겨준다 (VEcommandRecorder::recordParallel로 여러 thread에서 기록).
+
+enum class VEgraphAccess {
+	eColorWrite,	// color attachment
+	eDepthWrite,	// depth attachment (test + write)
+	eDepthRead,		// depth attachment (test only)
+	eSampled,		// fragment shader에서 sampling
+};
+
+struct VEgraphImageDesc {
+	vk::Format format;
+	vk::Extent2D extent{ 0, 0 };	// 0 -> backbuffer 크기를 따른다
+};
+
+class VErenderGraph {
+public:
+	using RecordFunc = std::function<void(vk::CommandBuffer)>;
+	using ParallelRecordFunc = std::function<void(vk::CommandBuffer, const vk::CommandBufferInheritanceInfo&)>;
+	using RetireFunc = std::function<void(std::function<void()>)>;
+
+	void init(vk::Device device, VEallocator& allocator, VEgpuProfiler* profiler = nullptr);
+	void cleanUp();
+
+	// ---- 선언 ----
+	uint32_t importBackbuffer(const std::string& name, vk::Format format, vk::ImageLayout finalLayout);
+	uint32_t createImage(const std::string& name, const VEgraphImageDesc& desc);
+	void markOutput(uint32_t resource);
+
+	uint32_t addPass(const std::string& name, RecordFunc record);
+	uint32_t addParallelPass(const std::string& name, ParallelRecordFunc record);
+	void writeColor(uint32_t pass, uint32_t resource, std::optional<vk::ClearValue> clear = std::nullopt);
+	void writeDepth(uint32_t pass, uint32_t resource, std::optional<vk::ClearValue> clear = std::nullopt);
+	void readDepth(uint32_t pass, uint32_t resource);
+	void readTexture(uint32_t pass, uint32_t resource);
+
+	// ---- 빌드 ----
+	void compile();
+
+	// swapchain (재)생성 시 : transient image, framebuffer를 새 크기로 다시 만든다
+	void setBackbuffer(const std::vector<vk::Image>& images, const std::vector<vk::ImageView>& views, vk::Extent2D extent);
+	void releaseTargets();
+	// 설정하면 releaseTargets의 파괴를 바로 하지 않고 넘겨준다 (사용중인 frame이 끝난 뒤 실행)
+	void setRetire(RetireFunc retire) { this->retire = std::move(retire); }
+
+	// ---- 실행 ----
+	void execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex);
+
+	vk::RenderPass getRenderPass(uint32_t pass) const { return passes[pass].renderPass; }
+	vk::ImageView getImageView(uint32_t resource) const { return resources[resource].view; }
+	bool isPassActive(uint32_t pass) const { return passes[pass].active; }
+	// framebuffer / render area 크기 (setBackbuffer 이후, viewport 설정용)
+	vk::Extent2D getPassExtent(uint32_t pass) const { return passes[pass].extent; }
+
+	// aliasing 전 / 후 transient 메모리 크기
+	vk::DeviceSize getTransientBytes() const { return transientBytes; }
+	vk::DeviceSize getAliasedBytes() const { return aliasedBytes; }
+	void printStats(std::ostream& out) const;
+private:
+	struct Access {
+		uint32_t resource;
+		VEgraphAccess type;
+		std::optional<vk::ClearValue> clear;
+	};
+
+	struct ImageState {
+		vk::ImageLayout layout;
+		vk::PipelineStageFlags stage;
+		vk::AccessFlags access;
+	};
+
+	struct Barrier {
+		uint32_t resource;
+		ImageState src;
+		ImageState dst;
+	};
+
+	struct Pass {
+		std::string name;
+		RecordFunc record;
+		ParallelRecordFunc parallelRecord;	// 있으면 renderpass 안은 secondary command buffer로만 기록한다
+		std::vector<Access> accesses;
+
+		bool active{ false };
+		bool usesBackbuffer{ false };
+		std::vector<Barrier> barriers;
+		std::vector<vk::ClearValue> clearValues;
+
+		vk::RenderPass renderPass;
+		std::vector<vk::Framebuffer> framebuffers;	// backbuffer를 쓰는 pass는 swapchain image 개수만큼
+		vk::Extent2D extent{};	// attachment 크기 (attachment가 없으면 backbuffer 크기)
+	};
+
+	struct Resource {
+		std::string name;
+		VEgraphImageDesc desc;
+		bool imported{ false };
+		bool output{ false };
+		vk::ImageLayout finalLayout{ vk::ImageLayout::eUndefined };
+
+		vk::ImageUsageFlags usage;
+		int firstPass{ -1 };
+		int lastPass{ -1 };
+
+		vk::Image image;
+		vk::ImageView view;
+	};
+
+	struct MemorySlot {
+		vk::MemoryRequirements requirements;
+		int lastPass;
+		VEallocation allocation;
+	};
+
+	vk::Device device;
+	VEallocator* allocator{ nullptr };
+	VEgpuProfiler* profiler{ nullptr };
+	RetireFunc retire;
+
+	std::vector<Pass> passes;
+	std::vector<Resource> resources;
+	std::vector<Barrier> finalBarriers;
+	std::vector<MemorySlot> slots;
+
+	uint32_t backbuffer{ ~0u };
+	std::vector<vk::Image> backbufferImages;
+	std::vector<vk::ImageView> backbufferViews;
+	vk::Extent2D extent{};
+
+	vk::DeviceSize transientBytes{ 0 };
+	vk::DeviceSize aliasedBytes{ 0 };
+
+	void cullPasses();
+	void computeBarriers();
+	void createRenderPasses();
+	void createTransientImages();
+	void createFramebuffers();
+
+	vk::Image resolveImage(uint32_t resource, uint32_t imageIndex) const;
+	vk::Extent2D getImageExtent(uint32_t resource) const;
+};
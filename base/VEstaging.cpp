@@ -0,0 +1,392 @@
+#include "VEstaging.h"
+
+#include <cstring>
+
+static constexpr vk::DeviceSize STAGING_ALIGNMENT = 16;
+
+static vk::Semaphore createTimelineSemaphore(vk::Device device) {
+	vk::SemaphoreTypeCreateInfo typeCI{
+		.semaphoreType = vk::SemaphoreType::eTimeline,
+		.initialValue = 0,
+	};
+
+	return device.createSemaphore({ .pNext = &typeCI });
+}
+
+// ------------- Submit Batch ----------------
+
+void VEsubmitBatch::wait(vk::Semaphore semaphore, vk::PipelineStageFlags stage, uint64_t value) {
+	waitSemaphores.push_back(semaphore);
+	waitStages.push_back(stage);
+	waitValues.push_back(value);
+}
+
+void VEsubmitBatch::signal(vk::Semaphore semaphore, uint64_t value) {
+	signalSemaphores.push_back(semaphore);
+	signalValues.push_back(value);
+}
+
+void VEsubmitBatch::submit(vk::Queue queue, vk::Fence fence) const {
+	vk::TimelineSemaphoreSubmitInfo timelineInfo{
+		.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size()),
+		.pWaitSemaphoreValues = waitValues.data(),
+		.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size()),
+		.pSignalSemaphoreValues = signalValues.data(),
+	};
+
+	vk::SubmitInfo submitInfo{
+		.pNext = &timelineInfo,
+		.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
+		.pWaitSemaphores = waitSemaphores.data(),
+		.pWaitDstStageMask = waitStages.data(),
+		.commandBufferCount = static_cast<uint32_t>(commandBuffers.size()),
+		.pCommandBuffers = commandBuffers.data(),
+		.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()),
+		.pSignalSemaphores = signalSemaphores.data(),
+	};
+
+	queue.submit(submitInfo, fence);
+}
+
+// ------------- Staging Upload Ring ----------------
+
+void VEstagingRing::init(vk::Device device, VEallocator& allocator, vk::Queue transferQueue, uint32_t transferFamily, uint32_t graphicsFamily,
+	vk::DeviceSize capacity) {
+	this->device = device;
+	this->allocator = &allocator;
+	this->queue = transferQueue;
+	this->transferFamily = transferFamily;
+	this->graphicsFamily = graphicsFamily;
+	this->capacity = capacity;
+
+	vk::BufferCreateInfo bufferCI{
+		.size = capacity,
+		.usage = vk::BufferUsageFlagBits::eTransferSrc,
+		.sharingMode = vk::SharingMode::eExclusive,
+	};
+
+	buffer = device.createBuffer(bufferCI);
+	allocation = allocator.allocate(device.getBufferMemoryRequirements(buffer),
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+
+	vk::CommandPoolCreateInfo commandPoolCI{
+		.flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+		.queueFamilyIndex = transferFamily,
+	};
+
+	commandPool = device.createCommandPool(commandPoolCI);
+	timeline = createTimelineSemaphore(device);
+
+	if (ownershipTransfer()) {
+		commandPoolCI.queueFamilyIndex = graphicsFamily;
+		acquirePool = device.createCommandPool(commandPoolCI);
+		acquireTimeline = createTimelineSemaphore(device);
+	}
+}
+
+void VEstagingRing::cleanUp() {
+	std::lock_guard lock(mutex);
+
+	flushLocked();
+	while (!inflightBatches.empty()) {
+		reclaimLocked(true);
+	}
+	freeBatches.clear();
+
+	if (ownershipTransfer()) {
+		vk::SemaphoreWaitInfo waitInfo{
+			.semaphoreCount = 1,
+			.pSemaphores = &acquireTimeline,
+			.pValues = &acquireValue,
+		};
+		std::ignore = device.waitSemaphores(waitInfo, UINT64_MAX);
+
+		device.destroyCommandPool(acquirePool);
+		device.destroySemaphore(acquireTimeline);
+	}
+
+	device.destroyCommandPool(commandPool);
+	device.destroySemaphore(timeline);
+	device.destroyBuffer(buffer);
+	allocator->free(allocation);
+}
+
+VEuploadToken VEstagingRing::upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, const void* data, vk::DeviceSize size) {
+	std::lock_guard lock(mutex);
+
+	// ring 보다 큰 데이터는 나누어 올린다
+	vk::DeviceSize maxChunk = capacity / 2;
+	auto src = static_cast<const char*>(data);
+
+	while (size > 0) {
+		vk::DeviceSize chunk = std::min(size, maxChunk);
+		uint64_t position = reserve(chunk);
+		vk::DeviceSize offset = position % capacity;
+
+		memcpy(static_cast<char*>(allocation.mapped) + offset, src, chunk);
+
+		auto found = copyListIndex.find(dstBuffer);
+		if (found == copyListIndex.end()) {
+			found = copyListIndex.emplace(dstBuffer, copyLists.size()).first;
+			copyLists.push_back({ .dstBuffer = dstBuffer });
+		}
+
+		copyLists[found->second].regions.push_back(vk::BufferCopy{
+			.srcOffset = offset,
+			.dstOffset = dstOffset,
+			.size = chunk,
+		});
+
+		src += chunk;
+		dstOffset += chunk;
+		size -= chunk;
+	}
+
+	// 현재 기록중인 batch가 submit 될 때 받을 번호
+	return VEuploadToken{ nextValue };
+}
+
+VEuploadToken VEstagingRing::flush() {
+	std::lock_guard lock(mutex);
+	return VEuploadToken{ flushLocked() };
+}
+
+bool VEstagingRing::isComplete(VEuploadToken token) {
+	return device.getSemaphoreCounterValue(timeline) >= token.value;
+}
+
+void VEstagingRing::wait(VEuploadToken token) {
+	{
+		std::lock_guard lock(mutex);
+		if (token.value >= nextValue) {
+			flushLocked();
+		}
+	}
+
+	vk::SemaphoreWaitInfo waitInfo{
+		.semaphoreCount = 1,
+		.pSemaphores = &timeline,
+		.pValues = &token.value,
+	};
+	std::ignore = device.waitSemaphores(waitInfo, UINT64_MAX);
+}
+
+void VEstagingRing::waitOnGraphics(VEuploadToken token) {
+	std::lock_guard lock(mutex);
+
+	// 아직 submit 되지 않은 batch를 기다리면 deadlock 이므로 먼저 내보낸다
+	if (token.value >= nextValue) {
+		flushLocked();
+	}
+
+	graphicsWaitValue = std::max(graphicsWaitValue, token.value);
+}
+
+void VEstagingRing::prepareGraphicsSubmit(VEsubmitBatch& batch) {
+	std::lock_guard lock(mutex);
+
+	if (graphicsWaitValue == 0) return;
+
+	batch.wait(timeline, vk::PipelineStageFlagBits::eAllCommands, graphicsWaitValue);
+
+	// release 된 buffer들의 ownership을 graphics queue family로 가져온다
+	if (ownershipTransfer()) {
+		std::vector<vk::BufferMemoryBarrier> acquires;
+
+		std::erase_if(pendingAcquires, [&](const PendingAcquire& pending) {
+			if (pending.value > graphicsWaitValue) return false;
+
+			acquires.push_back(vk::BufferMemoryBarrier{
+				.srcAccessMask = vk::AccessFlagBits::eNone,
+				.dstAccessMask = vk::AccessFlagBits::eMemoryRead,
+				.srcQueueFamilyIndex = transferFamily,
+				.dstQueueFamilyIndex = graphicsFamily,
+				.buffer = pending.buffer,
+				.offset = 0,
+				.size = VK_WHOLE_SIZE,
+			});
+			return true;
+		});
+
+		if (!acquires.empty()) {
+			auto commandBuffer = acquireGraphicsCommandBuffer();
+
+			commandBuffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eAllCommands,
+				{}, nullptr, acquires, nullptr);
+			commandBuffer.end();
+
+			// frame의 command buffer 보다 앞에 실행되어야 한다
+			batch.commandBuffers.insert(batch.commandBuffers.begin(), commandBuffer);
+
+			acquireValue++;
+			batch.signal(acquireTimeline, acquireValue);
+			inflightAcquires.push_back({ acquireValue, commandBuffer });
+		}
+	}
+
+	graphicsWaitValue = 0;
+}
+
+void VEstagingRing::reclaim() {
+	std::lock_guard lock(mutex);
+	reclaimLocked(false);
+}
+
+// ring에서 size 만큼의 연속된 영역을 확보하고 absolute position을 반환한다
+uint64_t VEstagingRing::reserve(vk::DeviceSize size) {
+	size = (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+
+	while (true) {
+		uint64_t position = head;
+
+		// 끝에서 잘리는 경우 다음 바퀴의 처음부터 사용
+		if (position % capacity + size > capacity) {
+			position += capacity - position % capacity;
+		}
+
+		if (position + size - tail <= capacity) {
+			head = position + size;
+			return position;
+		}
+
+		// ring이 가득 참 : 현재 batch를 내보내고 가장 오래된 batch가 끝나길 기다린다
+		if (inflightBatches.empty()) {
+			flushLocked();
+		}
+		reclaimLocked(true);
+	}
+}
+
+uint64_t VEstagingRing::flushLocked() {
+	if (copyLists.empty()) {
+		batchStart = head;
+		return nextValue - 1;
+	}
+
+	reclaimLocked(false);
+
+	auto batch = acquireBatch();
+	batch.value = nextValue++;
+	batch.end = head;
+
+	batch.commandBuffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+	for (auto& copyList : copyLists) {
+		batch.commandBuffer.copyBuffer(buffer, copyList.dstBuffer, copyList.regions);
+	}
+
+	if (ownershipTransfer()) {
+		// transfer queue family -> graphics queue family (release)
+		std::vector<vk::BufferMemoryBarrier> releases;
+		for (auto& copyList : copyLists) {
+			releases.push_back(vk::BufferMemoryBarrier{
+				.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+				.dstAccessMask = vk::AccessFlagBits::eNone,
+				.srcQueueFamilyIndex = transferFamily,
+				.dstQueueFamilyIndex = graphicsFamily,
+				.buffer = copyList.dstBuffer,
+				.offset = 0,
+				.size = VK_WHOLE_SIZE,
+			});
+
+			pendingAcquires.push_back({ batch.value, copyList.dstBuffer });
+		}
+
+		batch.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+			{}, nullptr, releases, nullptr);
+	}
+	else {
+		// 같은 queue family : 이후 submit 되는 모든 작업이 upload 결과를 읽을 수 있도록 한다
+		vk::MemoryBarrier barrier{
+			.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+			.dstAccessMask = vk::AccessFlagBits::eMemoryRead,
+		};
+		batch.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands,
+			{}, barrier, nullptr, nullptr);
+	}
+
+	batch.commandBuffer.end();
+
+	VEsubmitBatch submitBatch{};
+	submitBatch.commandBuffers.push_back(batch.commandBuffer);
+	submitBatch.signal(timeline, batch.value);
+	submitBatch.submit(queue);
+
+	inflightBatches.push_back(batch);
+
+	copyLists.clear();
+	copyListIndex.clear();
+	batchStart = head;
+
+	return batch.value;
+}
+
+void VEstagingRing::reclaimLocked(bool wait) {
+	if (!inflightBatches.empty() && wait) {
+		vk::SemaphoreWaitInfo waitInfo{
+			.semaphoreCount = 1,
+			.pSemaphores = &timeline,
+			.pValues = &inflightBatches.front().value,
+		};
+		std::ignore = device.waitSemaphores(waitInfo, UINT64_MAX);
+	}
+
+	uint64_t completed = device.getSemaphoreCounterValue(timeline);
+
+	while (!inflightBatches.empty() && inflightBatches.front().value <= completed) {
+		tail = inflightBatches.front().end;
+		freeBatches.push_back(inflightBatches.front());
+		inflightBatches.pop_front();
+	}
+
+	if (ownershipTransfer()) {
+		uint64_t acquired = device.getSemaphoreCounterValue(acquireTimeline);
+
+		while (!inflightAcquires.empty() && inflightAcquires.front().first <= acquired) {
+			freeAcquires.push_back(inflightAcquires.front().second);
+			inflightAcquires.pop_front();
+		}
+	}
+}
+
+VEstagingRing::Batch VEstagingRing::acquireBatch() {
+	if (!freeBatches.empty()) {
+		auto batch = freeBatches.back();
+		freeBatches.pop_back();
+
+		batch.commandBuffer.reset();
+		return batch;
+	}
+
+	vk::CommandBufferAllocateInfo allocInfo{
+		.commandPool = commandPool,
+		.level = vk::CommandBufferLevel::ePrimary,
+		.commandBufferCount = 1,
+	};
+
+	return Batch{
+		.commandBuffer = device.allocateCommandBuffers(allocInfo).front(),
+	};
+}
+
+vk::CommandBuffer VEstagingRing::acquireGraphicsCommandBuffer() {
+	reclaimLocked(false);
+
+	if (!freeAcquires.empty()) {
+		auto commandBuffer = freeAcquires.back();
+		freeAcquires.pop_back();
+
+		commandBuffer.reset();
+		return commandBuffer;
+	}
+
+	vk::CommandBufferAllocateInfo allocInfo{
+		.commandPool = acquirePool,
+		.level = vk::CommandBufferLevel::ePrimary,
+		.commandBufferCount = 1,
+	};
+
+	return device.allocateCommandBuffers(allocInfo).front();
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "VEallocator.h"
+
+#include <deque>
+
+// ------------- Submit Batch ----------------
+
+// queue submit 한번에 필요한 정보를 모아두는 용도
+// binary semaphore와 timeline semaphore를 섞어 쓸 수 있다 (binary는 value를 0으로 둔다)
+struct VEsubmitBatch {
+	std::vector<vk::Semaphore> waitSemaphores;
+	std::vector<uint64_t> waitValues;
+	std::vector<vk::PipelineStageFlags> waitStages;
+	std::vector<vk::CommandBuffer> commandBuffers;
+	std::vector<vk::Semaphore> signalSemaphores;
+	std::vector<uint64_t> signalValues;
+
+	void wait(vk::Semaphore semaphore, vk::PipelineStageFlags stage, uint64_t value = 0);
+	void signal(vk::Semaphore semaphore, uint64_t value = 0);
+
+	void submit(vk::Queue queue, vk::Fence fence = nullptr) const;
+};
+
+// ------------- Staging Upload Ring ----------------
+//
+// 매 upload 마다 staging buffer 생성 + submit + waitIdle 하는 대신
+// persistent map 된 하나의 ring buffer에 데이터를 복사해두고,
+// copy 명령은 하나의 command buffer(batch)에 모아서 flush() 때 한번에 submit 한다.
+//
+// batch는 transfer 전용 queue가 있으면 그 queue에 submit 되고, 완료 시 timeline semaphore를
+// batch 번호로 signal 한다. upload / flush가 돌려주는 token은 그 번호이며
+//	- isComplete(token)		: CPU에서 완료 여부 확인 (대기 없음)
+//	- waitOnGraphics(token)	: 다음 graphics submit이 GPU에서 token을 기다리도록 한다
+// transfer queue family가 graphics와 다르면 batch 끝에서 release barrier를 기록하고,
+// waitOnGraphics 이후 graphics submit 앞에 acquire barrier를 넣어 ownership을 넘긴다.
+//
+// ring 위치는 단조 증가하는 64bit 값으로 관리한다 (실제 offset = position % capacity).
+// timeline 값이 batch 번호에 도달하면 해당 batch가 사용한 영역까지 tail을 전진시켜 재사용한다.
+// ring이 가득 찬 경우에만 가장 오래된 batch를 CPU에서 기다린다.
+//
+// upload 대상은 새로 만든 (아직 graphics queue가 소유하지 않은) buffer를 가정한다.
+
+struct VEuploadToken {
+	uint64_t value{ 0 };
+};
+
+class VEstagingRing {
+public:
+	void init(vk::Device device, VEallocator& allocator, vk::Queue transferQueue, uint32_t transferFamily, uint32_t graphicsFamily,
+		vk::DeviceSize capacity = 32 * 1024 * 1024);
+	void cleanUp();
+
+	// data를 ring에 복사하고 dst buffer로의 copy를 현재 batch에 기록한다
+	VEuploadToken upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, const void* data, vk::DeviceSize size);
+
+	// 현재 batch를 transfer queue에 submit 한다 (기록된 upload가 없으면 마지막 batch의 token)
+	VEuploadToken flush();
+
+	bool isComplete(VEuploadToken token);
+	void wait(VEuploadToken token);
+
+	// 다음 graphics submit이 token 까지의 upload를 GPU에서 기다리도록 한다
+	void waitOnGraphics(VEuploadToken token);
+
+	// graphics queue submit 직전에 호출 : 요청된 대기와 ownership acquire를 batch에 추가한다
+	void prepareGraphicsSubmit(VEsubmitBatch& batch);
+
+	// 완료된 batch의 ring 영역을 회수한다 (대기하지 않음)
+	void reclaim();
+
+	vk::DeviceSize getPendingBytes() const { return head - batchStart; }
+private:
+	struct Batch {
+		vk::CommandBuffer commandBuffer;
+		uint64_t value{ 0 };	// 완료 시 signal 되는 timeline 값
+		uint64_t end{ 0 };		// 이 batch가 사용한 ring 영역의 끝 (absolute position)
+	};
+
+	struct CopyList {
+		vk::Buffer dstBuffer;
+		std::vector<vk::BufferCopy> regions;
+	};
+
+	struct PendingAcquire {
+		uint64_t value;
+		vk::Buffer buffer;
+	};
+
+	vk::Device device;
+	VEallocator* allocator{ nullptr };
+	vk::Queue queue;
+	uint32_t transferFamily{ 0 };
+	uint32_t graphicsFamily{ 0 };
+	vk::CommandPool commandPool;
+
+	vk::Buffer buffer;
+	VEallocation allocation;
+	vk::DeviceSize capacity{ 0 };
+
+	uint64_t head{ 0 };
+	uint64_t tail{ 0 };
+	uint64_t batchStart{ 0 };
+
+	vk::Semaphore timeline;
+	uint64_t nextValue{ 1 };
+
+	// dst buffer 별로 region을 모아서 flush 때 한번의 copyBuffer로 기록한다
+	std::vector<CopyList> copyLists;
+	std::unordered_map<VkBuffer, size_t> copyListIndex;
+
+	std::deque<Batch> inflightBatches;
+	std::vector<Batch> freeBatches;
+
+	// graphics queue 쪽 : ownership acquire용 command buffer와 그 완료를 알리는 timeline
+	uint64_t graphicsWaitValue{ 0 };
+	std::vector<PendingAcquire> pendingAcquires;
+	vk::CommandPool acquirePool;
+	vk::Semaphore acquireTimeline;
+	uint64_t acquireValue{ 0 };
+	std::deque<std::pair<uint64_t, vk::CommandBuffer>> inflightAcquires;
+	std::vector<vk::CommandBuffer> freeAcquires;
+
+	std::mutex mutex;
+
+	bool ownershipTransfer() const { return transferFamily != graphicsFamily; }
+
+	uint64_t reserve(vk::DeviceSize size);
+	uint64_t flushLocked();
+	void reclaimLocked(bool wait);
+	Batch acquireBatch();
+	vk::CommandBuffer acquireGraphicsCommandBuffer();
+};
@@ -0,0 +1,64 @@
+#include "VEtrace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+static const auto traceEpoch = std::chrono::steady_clock::now();
+
+double traceClockUs() {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+double traceTicksToUs(int64_t ticks) {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(ticks) - traceEpoch.time_since_epoch()).count();
+}
+
+static void writeEscaped(std::ostream& out, const std::string& text) {
+	for (char c : text) {
+		if (c == '"' || c == '\\') out << '\\';
+		out << c;
+	}
+}
+
+void writeChromeTrace(std::ostream& out, const std::vector<VEtraceEvent>& events) {
+	out << "{\"traceEvents\":[\n";
+
+	// process 이름
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << VE_TRACE_CPU << ",\"args\":{\"name\":\"CPU\"}},\n";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << VE_TRACE_GPU << ",\"args\":{\"name\":\"GPU\"}}";
+
+	std::set<std::pair<uint32_t, uint32_t>> threads;
+	for (auto& event : events) {
+		threads.insert({ event.pid, event.tid });
+	}
+	for (auto& [pid, tid] : threads) {
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+			<< ",\"args\":{\"name\":\"" << (pid == VE_TRACE_GPU ? "queue " : "thread ") << tid << "\"}}";
+	}
+
+	for (auto& event : events) {
+		out << ",\n{\"name\":\"";
+		writeEscaped(out, event.name);
+		out << "\",\"ph\":\"X\",\"pid\":" << event.pid << ",\"tid\":" << event.tid
+			<< ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs << "}";
+	}
+
+	out << "\n]}\n";
+}
+
+bool writeChromeTrace(const std::string& path, const std::vector<VEtraceEvent>& events) {
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		std::cout << "trace : failed to open " << path << "\n";
+		return false;
+	}
+
+	file.precision(3);
+	file << std::fixed;
+	writeChromeTrace(file, events);
+
+	std::cout << "trace : " << events.size() << " events written to " << path << "\n";
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// ------------- Trace Export ----------------
+//
+// CPU / GPU profiler가 만든 구간들을 Chrome trace (chrome://tracing, Perfetto) JSON으로 내보낸다.
+// 시간은 모두 traceClockUs() 기준 microsecond.
+
+enum VEtraceProcess : uint32_t {
+	VE_TRACE_CPU = 1,
+	VE_TRACE_GPU = 2,
+};
+
+struct VEtraceEvent {
+	std::string name;
+	uint32_t pid;		// VEtraceProcess
+	uint32_t tid;
+	double startUs;
+	double durationUs;
+};
+
+// profiler들이 공유하는 기준 시계 (steady clock, 프로세스 시작 후 경과 시간)
+double traceClockUs();
+// std::chrono::steady_clock tick (time_since_epoch().count()) -> traceClockUs 기준
+double traceTicksToUs(int64_t ticks);
+
+void writeChromeTrace(std::ostream& out, const std::vector<VEtraceEvent>& events);
+bool writeChromeTrace(const std::string& path, const std::vector<VEtraceEvent>& events);
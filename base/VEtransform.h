@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// ------------- Draw Transform ----------------
+//
+// object 마다 push constant로 넘기는 transform.
+// vertex shader가 vertex 마다 proj * view * model을 곱하는 대신 CPU에서 object 당 한 번 곱해둔다.
+// 크기는 push constant 최소 보장 크기 (128 byte) 안에 들어가야 한다.
+//	VEdrawMvp		: mvp만 (64 byte). normal을 쓰지 않는 shader
+//	VEdrawTransform	: mvp + normal 행렬 (112 byte). lighting 하는 shader (normal 행렬에 inverse가 든다)
+//
+// shader 쪽 선언 (push constant block은 std430, mat3의 열은 vec4 간격)
+//	layout(push_constant) uniform Draw { mat4 mvp; } draw;
+//	layout(push_constant) uniform Draw { mat4 mvp; mat3 normalMatrix; } draw;
+
+struct VEdrawMvp {
+	glm::mat4 mvp;
+};
+
+struct VEdrawTransform {
+	glm::mat4 mvp;
+	glm::mat3x4 normalMatrix;	// world 공간 normal 변환 (열 3개, 각 열은 vec4로 padding)
+};
+
+static_assert(sizeof(VEdrawTransform) <= 128, "push constant는 128 byte까지만 보장된다");
+
+inline VEdrawMvp makeDrawMvp(const glm::mat4& viewProj, const glm::mat4& model) {
+	return VEdrawMvp{ .mvp = viewProj * model };
+}
+
+inline VEdrawTransform makeDrawTransform(const glm::mat4& viewProj, const glm::mat4& model) {
+	auto normal = glm::transpose(glm::inverse(glm::mat3(model)));
+
+	return VEdrawTransform{
+		.mvp = viewProj * model,
+		.normalMatrix = glm::mat3x4(glm::vec4(normal[0], 0.0f), glm::vec4(normal[1], 0.0f), glm::vec4(normal[2], 0.0f)),
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// ------------- Triple Buffer ----------------
+//
+// 한 thread가 쓰고 (simulation) 다른 한 thread가 읽는 (render) frame 상태 snapshot.
+// slot 3개를 writer (back), 교환용 (middle), reader (front)가 하나씩 나눠 갖고
+// publish / acquire 때 middle과 atomic exchange로 맞바꾼다. lock도 대기도 없다.
+//	- writer : back()을 채우고 publish()
+//	- reader : acquire()로 가장 최근에 publish 된 값을 front()로 가져온다 (새 값이 없으면 이전 front 유지)
+// publish 후 back()은 예전 slot이므로 writer는 매번 값을 전부 다시 써야 한다.
+
+template <typename T>
+class VEtripleBuffer {
+public:
+	// ---- writer ----
+	T& back() { return slots[backIndex]; }
+
+	void publish() {
+		backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// reader가 마지막 publish를 가져갔는지
+	bool isConsumed() const { return (middle.load(std::memory_order_acquire) & FRESH) == 0; }
+
+	// ---- reader ----
+	bool acquire() {
+		if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+
+		frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	const T& front() const { return slots[frontIndex]; }
+private:
+	static constexpr uint32_t INDEX_MASK = 3;
+	static constexpr uint32_t FRESH = 4;	// middle에 아직 읽지 않은 값이 있다
+
+	T slots[3]{};
+
+	alignas(64) uint32_t backIndex{ 0 };			// writer 전용
+	alignas(64) std::atomic<uint32_t> middle{ 1 };
+	alignas(64) uint32_t frontIndex{ 2 };			// reader 전용
+};
@@ -0,0 +1,71 @@
+#include "VEuniformRing.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void VEuniformRing::init(vk::PhysicalDevice physicalDevice, vk::Device device, VEallocator& allocator, uint32_t framesInFlight,
+	vk::DeviceSize bytesPerFrame) {
+	this->device = device;
+	this->allocator = &allocator;
+	this->framesInFlight = framesInFlight;
+
+	// dynamic offset은 이 값의 배수여야 한다 (항상 2의 거듭제곱)
+	alignment = std::max<vk::DeviceSize>(physicalDevice.getProperties().limits.minUniformBufferOffsetAlignment, 16);
+	this->bytesPerFrame = alignUp(bytesPerFrame, alignment);
+
+	vk::BufferCreateInfo bufferCI{
+		.size = this->bytesPerFrame * framesInFlight,
+		.usage = vk::BufferUsageFlagBits::eUniformBuffer,
+		.sharingMode = vk::SharingMode::eExclusive,
+	};
+
+	buffer = device.createBuffer(bufferCI);
+	allocation = allocator.allocate(device.getBufferMemoryRequirements(buffer),
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+
+	frameBase = 0;
+	head = 0;
+}
+
+void VEuniformRing::cleanUp() {
+	device.destroyBuffer(buffer);
+	allocator->free(allocation);
+	buffer = nullptr;
+}
+
+void VEuniformRing::beginFrame(uint32_t frameIndex) {
+	peakBytes = std::max(peakBytes, head.load(std::memory_order_relaxed));
+
+	frameBase = bytesPerFrame * (frameIndex % framesInFlight);
+	head.store(0, std::memory_order_relaxed);
+}
+
+uint32_t VEuniformRing::allocate(vk::DeviceSize size, void** mapped) {
+	auto alignedSize = alignUp(size, alignment);
+	auto offset = head.fetch_add(alignedSize, std::memory_order_relaxed);
+
+	if (offset + alignedSize > bytesPerFrame) {
+		throw std::runtime_error("uniform ring : frame slot is full");
+	}
+
+	*mapped = static_cast<char*>(allocation.mapped) + frameBase + offset;
+	return static_cast<uint32_t>(frameBase + offset);
+}
+
+vk::DescriptorBufferInfo VEuniformRing::getDescriptorInfo(vk::DeviceSize range) const {
+	return vk::DescriptorBufferInfo{
+		.buffer = buffer,
+		.offset = 0,
+		.range = range,
+	};
+}
+
+void VEuniformRing::printStats(std::ostream& out) const {
+	out << "uniform ring: " << framesInFlight << " x " << bytesPerFrame / 1024 << " KB, peak " << peakBytes / 1024
+		<< " KB / frame (alignment " << alignment << ")\n";
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "VEallocator.h"
+
+#include <atomic>
+#include <cstring>
+#include <ostream>
+
+// ------------- Uniform Ring ----------------
+//
+// object 마다 uniform buffer를 따로 만드는 대신 persistent map 된 buffer 하나를
+// frame in flight slot 수 만큼 나눠 두고, 각 slot 안을 앞에서부터 잘라 쓴다 (linear allocator).
+//	- beginFrame(frame)	: 그 slot의 frame이 GPU에서 끝난 뒤 (VEbase::beginFrame) 위치를 0으로 되돌린다
+//	- push(data)		: minUniformBufferOffsetAlignment로 맞춰 복사하고 dynamic offset을 돌려준다
+// descriptor는 eUniformBufferDynamic 하나 (buffer 전체, range = object 당 크기)를 만들어 두고
+// bindDescriptorSets의 dynamic offset으로 object를 고른다. 모든 slot이 같은 buffer이므로 set도 하나면 된다.
+//
+// 위치는 atomic으로 올리므로 병렬 기록 중 여러 thread에서 push 해도 된다.
+// slot이 가득 차면 예외를 던진다 (bytesPerFrame을 늘려야 한다).
+
+class VEuniformRing {
+public:
+	void init(vk::PhysicalDevice physicalDevice, vk::Device device, VEallocator& allocator, uint32_t framesInFlight,
+		vk::DeviceSize bytesPerFrame = 4 * 1024 * 1024);
+	void cleanUp();
+
+	void beginFrame(uint32_t frameIndex);
+
+	// size 만큼 잘라내고 dynamic offset을 돌려준다 (mapped에 쓸 위치)
+	uint32_t allocate(vk::DeviceSize size, void** mapped);
+
+	template <typename T>
+	uint32_t push(const T& data) {
+		void* mapped{};
+		auto offset = allocate(sizeof(T), &mapped);
+		memcpy(mapped, &data, sizeof(T));
+		return offset;
+	}
+
+	vk::Buffer getBuffer() const { return buffer; }
+	vk::DeviceSize getAlignment() const { return alignment; }
+
+	// eUniformBufferDynamic descriptor에 쓸 정보 (range = object 당 크기)
+	vk::DescriptorBufferInfo getDescriptorInfo(vk::DeviceSize range) const;
+
+	void printStats(std::ostream& out) const;
+private:
+	vk::Device device;
+	VEallocator* allocator{ nullptr };
+
+	vk::Buffer buffer;
+	VEallocation allocation;
+
+	vk::DeviceSize alignment{ 256 };
+	vk::DeviceSize bytesPerFrame{ 0 };
+
+	vk::DeviceSize frameBase{ 0 };				// 현재 slot의 시작
+	std::atomic<vk::DeviceSize> head{ 0 };		// 현재 slot 안에서 다음 위치
+	uint32_t framesInFlight{ 0 };
+
+	vk::DeviceSize peakBytes{ 0 };
+};
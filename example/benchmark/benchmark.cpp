@@ -0,0 +1,1105 @@
+#include "VEbase.h"
+#include "VEculling.h"
+#include "VEgpuCulling.h"
+#include "VEtransform.h"
+
+#include <cmath>
+
+// headless로 scene 마다 고정된 frame 수를 렌더링하고 frame 시간 통계를 JSON으로 출력한다
+//	triangle	: triangle 예제와 같은 shader, triangle 1개
+//	uniform		: uniform 예제와 같은 shader, 회전하는 quad 1개
+//	grid-N		: N x N quad를 생성한 scene
+//	draws-N		: grid와 같지만 quad 마다 draw call 하나 (여러 thread에서 secondary command buffer로 기록)
+//	push-N		: draws-N과 같지만 quad 마다 자기 중심으로 돌고, CPU에서 곱한 MVP를 push constant로 넘긴다 (UBO 없음)
+//	cull-N		: push-N과 같지만 camera가 가까이 있고, frustum 밖의 quad는 기록하지 않는다 (VEculler)
+//	gpu-N		: cull-N과 같은 화면을 compute shader로 culling 하고 drawIndexedIndirectCount 한 번으로 그린다 (VEgpuCuller)
+//				  quad 회전도 vertex shader에서 하므로 CPU 기록량은 quad 수와 관계없다
+// camera는 실제 시간이 아니라 frame 번호로 정해지는 궤도를 돌기 때문에 매 실행 같은 화면을 그린다.
+//
+//	benchmark --frames 500 --output result.json
+class Benchmark : public VEbase {
+public:
+	Benchmark(const VEsettings& settings) : VEbase("Vulkan Application - Benchmark", settings) {
+
+	}
+
+	~Benchmark() {
+		for (auto i = 0; i < framesInFlight; i++) {
+			destroyBuffer(uniformData[i].buffer, uniformData[i].allocation);
+			device.destroySemaphore(renderSemaphores[i]);
+		}
+
+		descriptorTemplate.cleanUp();
+		device.destroyDescriptorSetLayout(descriptorSetLayout);
+
+		destroyFrameBuffers();
+
+		device.destroyPipeline(trianglePipeline);
+		device.destroyPipeline(uniformPipeline);
+		device.destroyPipeline(pushPipeline);
+		device.destroyPipelineLayout(trianglePipelineLayout);
+		device.destroyPipelineLayout(uniformPipelineLayout);
+		device.destroyPipelineLayout(pushPipelineLayout);
+
+		if (gpuCullEnabled) {
+			device.destroyPipeline(gpuPipeline);
+			device.destroyPipelineLayout(gpuPipelineLayout);
+			gpuCuller.printStats(std::cout);
+			gpuCuller.cleanUp();
+		}
+
+		device.destroyPipeline(postPipeline);
+		device.destroyPipeline(presentPipeline);
+		device.destroyPipelineLayout(postPipelineLayout);
+		postTemplate.cleanUp();
+		device.destroyDescriptorSetLayout(postSetLayout);
+		device.destroySampler(postSampler);
+
+		cleanUpBase();
+	}
+
+	void run() {
+		init();
+		prepare();
+
+		scenes.push_back(createTriangleScene());
+		scenes.push_back(createQuadScene());
+		scenes.push_back(createGridScene(64));
+		scenes.push_back(createGridScene(256));
+		scenes.push_back(createGridScene(224, true));	// 50176 draws
+		if (pushEnabled) {
+			scenes.push_back(createGridScene(224, true, true));	// 50176 draws, push constant transform
+			scenes.push_back(createGridScene(224, true, true, true));	// push-224 + frustum culling
+		}
+		else {
+			std::cout << "benchmark : push/push.vert.spv not found (compile shaders/push), skipping push and cull scenes\n";
+		}
+		if (gpuCullEnabled) {
+			scenes.push_back(createGridScene(224, true, false, false, true));	// cull-224을 GPU에서
+		}
+		else if (!gpuCullShaders) {
+			std::cout << "benchmark : gpuculling/cull.comp.spv or gpuculling.vert.spv not found (compile shaders/gpuculling), skipping gpu scene\n";
+		}
+		else {
+			std::cout << "benchmark : multiDrawIndirect is not supported, skipping gpu scene\n";
+		}
+
+		for (auto& scene : scenes) {
+			runScene(scene);
+		}
+
+		writeResults();
+	}
+
+private:
+	// 통계에서 제외하는 시작 frame 수 (pipeline, cache warm-up)
+	static constexpr uint32_t WARMUP_FRAMES = 10;
+
+	struct Vertex {
+		glm::vec2 pos;
+		glm::vec3 color;
+	};
+
+	struct Scene {
+		std::string name;
+		bool useUniform;
+		float cameraDistance;
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		uint32_t draws{ 1 };	// indices를 같은 크기로 나눠 draw call 여러 번
+		bool pushTransform{ false };	// draw 마다 VEdrawMvp를 push constant로
+		std::vector<glm::vec2> centers;	// pushTransform : draw 별 object 중심
+		bool cull{ false };				// draw 별 bounding sphere로 frustum culling (pushTransform 필요)
+		VEsphereBounds bounds;
+		bool gpuCull{ false };			// culling과 draw command 생성을 compute shader에서 (VEgpuCuller)
+		std::vector<VEgpuObject> objects;
+
+		// 결과
+		std::vector<double> cpuFrameMs;
+		std::vector<double> gpuFrameMs;
+		std::vector<double> recordMs;	// renderpass 안의 command 기록 시간
+		std::vector<double> visibleDraws;	// culling 후 기록한 draw 수
+		double seconds{ 0.0 };
+	};
+
+	struct UniformBufferObject {
+		glm::mat4 model;
+		glm::mat4 view;
+		glm::mat4 proj;
+	};
+
+	struct UniformData {
+		vk::Buffer buffer;
+		VEallocation allocation;
+	};
+
+	std::vector<Scene> scenes;
+	Scene* currentScene{ nullptr };
+	uint32_t sceneFrame{ 0 };
+
+	vk::Buffer vertexBuffer;
+	VEallocation vertexAllocation;
+	vk::Buffer indexBuffer;
+	VEallocation indexAllocation;
+
+	std::vector<UniformData> uniformData;
+	vk::DescriptorSetLayout descriptorSetLayout;
+	VEdescriptorTemplate descriptorTemplate;
+	std::vector<vk::DescriptorSet> descriptorSets;	// frame 마다 frameDescriptors에서 새로 할당
+
+	vk::PipelineLayout trianglePipelineLayout;
+	vk::PipelineLayout uniformPipelineLayout;
+	vk::PipelineLayout pushPipelineLayout;
+	vk::Pipeline trianglePipeline;
+	vk::Pipeline uniformPipeline;
+	vk::Pipeline pushPipeline;
+	bool pushEnabled{ false };
+
+	// push scene : 이번 frame의 camera와 scene 회전 (draw 마다 model과 곱한다)
+	glm::mat4 viewProj{ 1.0f };
+	glm::mat4 sceneModel{ 1.0f };
+	float sceneAngle{ 0.0f };
+
+	// cull scene : 이번 frame에 보이는 draw 번호
+	VEculler culler;
+	uint32_t drawCount{ 0 };
+
+	// gpu scene : vertex shader가 object buffer에서 중심을 읽어 회전시킨다
+	struct GpuDrawConstants {
+		glm::mat4 viewProjModel;
+		float angle;
+	};
+
+	VEgpuCuller gpuCuller;
+	bool gpuCullEnabled{ false };
+	bool gpuCullShaders{ false };
+	VEfrustum gpuFrustum{};		// 마지막 frame의 frustum (끝난 뒤 CPU 결과와 비교)
+	vk::PipelineLayout gpuPipelineLayout;
+	vk::Pipeline gpuPipeline;
+
+	// render graph : scene -> (vignette -> present) -> backbuffer
+	// post shader가 없으면 scene pass가 backbuffer에 바로 그린다
+	uint32_t backbuffer;
+	uint32_t sceneDepth;
+	uint32_t sceneColor;
+	uint32_t postColor;
+	uint32_t scenePass;
+	uint32_t vignettePass;
+	uint32_t presentPass;
+	uint32_t debugPass;
+
+	bool postEnabled{ false };
+	vk::Sampler postSampler;
+	vk::DescriptorSetLayout postSetLayout;
+	VEdescriptorTemplate postTemplate;
+	vk::PipelineLayout postPipelineLayout;
+	vk::Pipeline postPipeline;		// vignette / debug pass (R8G8B8A8 target)
+	vk::Pipeline presentPipeline;	// present pass (swapchain format)
+
+	uint32_t currentFrame{ 0 };
+
+	vk::VertexInputBindingDescription binding{
+		.binding = 0,
+		.stride = sizeof(Vertex),
+		.inputRate = vk::VertexInputRate::eVertex,
+	};
+
+	std::array<vk::VertexInputAttributeDescription, 2> attributes{
+		vk::VertexInputAttributeDescription {
+			.location = 0,
+			.binding = 0,
+			.format = vk::Format::eR32G32Sfloat,
+			.offset = 0,
+		},
+		vk::VertexInputAttributeDescription {
+			.location = 1,
+			.binding = 0,
+			.format = vk::Format::eR32G32B32Sfloat,
+			.offset = offsetof(Vertex, color),
+		},
+	};
+
+	// ---- scenes ----
+
+	Scene createTriangleScene() {
+		return Scene{
+			.name = "triangle",
+			.useUniform = false,
+			.cameraDistance = 0.0f,
+			.vertices = {
+				{{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+				{{0.5f, 0.5f}, {0.0f, 1.0f, 0.0f}},
+				{{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
+			},
+			.indices = { 0, 1, 2 },
+		};
+	}
+
+	Scene createQuadScene() {
+		return Scene{
+			.name = "uniform",
+			.useUniform = true,
+			.cameraDistance = 2.0f,
+			.vertices = {
+				{{-0.5, -0.5f}, {1.0f, 0.0f, 0.0f}},
+				{{-0.5f, 0.5f}, {0.0f, 1.0f, 0.0f}},
+				{{0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}},
+				{{0.5f, 0.5f}, {0.0f, 1.0f, 1.0f}},
+			},
+			.indices = { 0, 2, 1, 1, 2, 3 },
+		};
+	}
+
+	// [-1, 1] 평면을 N x N 칸으로 나누고 칸 마다 quad 하나
+	// drawPerQuad : quad 마다 draw call을 따로 기록한다
+	// pushTransform : quad 마다 다른 model 행렬을 push constant로 (drawPerQuad 필요)
+	// cull : quad 마다 bounding sphere를 두고 frustum 밖의 quad는 그리지 않는다 (pushTransform 필요)
+	// gpuCull : cull과 같은 판정과 quad 회전을 GPU에서 한다 (drawPerQuad 필요)
+	Scene createGridScene(uint32_t n, bool drawPerQuad = false, bool pushTransform = false, bool cull = false, bool gpuCull = false) {
+		Scene scene{
+			.name = (gpuCull ? "gpu-" : cull ? "cull-" : pushTransform ? "push-" : drawPerQuad ? "draws-" : "grid-") + std::to_string(n),
+			.useUniform = !pushTransform && !gpuCull,
+			.cameraDistance = cull || gpuCull ? 1.2f : 2.5f,	// grid 일부가 화면 밖으로 나가도록
+			.draws = drawPerQuad ? n * n : 1,
+			.pushTransform = pushTransform,
+			.cull = cull,
+			.gpuCull = gpuCull,
+		};
+
+		scene.vertices.reserve(n * n * 4);
+		scene.indices.reserve(n * n * 6);
+
+		float cell = 2.0f / n;
+		float half = cell * 0.4f;
+
+		for (uint32_t y = 0; y < n; y++) {
+			for (uint32_t x = 0; x < n; x++) {
+				glm::vec2 center{ -1.0f + cell * (x + 0.5f), -1.0f + cell * (y + 0.5f) };
+				glm::vec3 color{ static_cast<float>(x) / n, static_cast<float>(y) / n, 0.5f };
+
+				auto base = static_cast<uint32_t>(scene.vertices.size());
+				scene.vertices.push_back({ center + glm::vec2(-half, -half), color });
+				scene.vertices.push_back({ center + glm::vec2(-half, half), color });
+				scene.vertices.push_back({ center + glm::vec2(half, -half), color });
+				scene.vertices.push_back({ center + glm::vec2(half, half), color });
+
+				for (auto index : { 0u, 2u, 1u, 1u, 2u, 3u }) {
+					scene.indices.push_back(base + index);
+				}
+
+				if (pushTransform) {
+					scene.centers.push_back(center);
+				}
+
+				// quad는 자기 중심으로만 돌기 때문에 scene model 공간에서 sphere는 변하지 않는다
+				if (cull || gpuCull) {
+					scene.bounds.add(glm::vec3(center, 0.0f), half * std::sqrt(2.0f));
+				}
+
+				if (gpuCull) {
+					scene.objects.push_back(VEgpuObject{
+						.sphere = glm::vec4(center, 0.0f, half * std::sqrt(2.0f)),
+						.indexCount = 6,
+						.firstIndex = static_cast<uint32_t>(scene.indices.size()) - 6,
+						.vertexOffset = 0,
+					});
+				}
+			}
+		}
+
+		return scene;
+	}
+
+	void loadScene(Scene& scene) {
+		auto vertexSize = sizeof(Vertex) * scene.vertices.size();
+		createBuffer(vertexSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, vertexBuffer, vertexAllocation);
+		staging.upload(vertexBuffer, 0, scene.vertices.data(), vertexSize);
+
+		auto indexSize = sizeof(uint32_t) * scene.indices.size();
+		createBuffer(indexSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, indexBuffer, indexAllocation);
+		staging.upload(indexBuffer, 0, scene.indices.data(), indexSize);
+
+		if (scene.gpuCull) {
+			gpuCuller.setObjects(staging, scene.objects);
+		}
+
+		staging.waitOnGraphics(staging.flush());
+	}
+
+	// 다음 scene을 기다리지 않고 올릴 수 있도록 deletion queue로 넘긴다
+	void unloadScene() {
+		retireBuffer(vertexBuffer, vertexAllocation);
+		retireBuffer(indexBuffer, indexAllocation);
+	}
+
+	void runScene(Scene& scene) {
+		loadScene(scene);
+		currentScene = &scene;
+
+		uint32_t totalFrames = WARMUP_FRAMES + settings.headlessFrames;
+		auto gpuFrames = gpuProfiler.getResolvedFrameCount();
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		for (sceneFrame = 0; sceneFrame < totalFrames; sceneFrame++) {
+			if (sceneFrame == WARMUP_FRAMES) {
+				startTime = std::chrono::high_resolution_clock::now();
+			}
+
+			auto frameStart = std::chrono::high_resolution_clock::now();
+			{
+				VE_PROFILE_ZONE("drawFrame");
+				drawFrame();
+			}
+			auto frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+			VE_PROFILE_FRAME();
+
+			if (sceneFrame >= WARMUP_FRAMES) {
+				scene.cpuFrameMs.push_back(frameMs);
+				scene.recordMs.push_back(commandRecorder.getLastRecordMs());
+				scene.visibleDraws.push_back(drawCount);
+			}
+
+			// GPU 결과는 framesInFlight frame 늦게 들어온다
+			if (gpuProfiler.getResolvedFrameCount() != gpuFrames) {
+				gpuFrames = gpuProfiler.getResolvedFrameCount();
+				if (sceneFrame >= WARMUP_FRAMES + framesInFlight) {
+					scene.gpuFrameMs.push_back(gpuProfiler.getFrameTimeMs());
+				}
+			}
+		}
+
+		// scene 시간과 verifyGpuCull 용 (scene 교체 자체는 retire / slot 별 beginFrame이라 기다리지 않아도 된다)
+		device.waitIdle();
+		scene.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		if (scene.gpuCull) {
+			verifyGpuCull(scene);
+			gpuCuller.releaseObjects();
+		}
+
+		unloadScene();
+		currentScene = nullptr;
+	}
+
+	// 마지막 frame의 GPU culling 결과를 같은 frustum의 CPU 결과 (VEculler)와 비교한다 (device idle 상태에서)
+	void verifyGpuCull(const Scene& scene) {
+		culler.cull(nullptr, gpuFrustum, scene.bounds);
+
+		auto gpuVisible = gpuCuller.getVisibleCount(currentFrame);
+		std::cout << "benchmark : " << scene.name << " visible " << gpuVisible;
+		if (gpuVisible != culler.getVisibleCount()) {
+			std::cout << " (mismatch : cpu " << culler.getVisibleCount() << ")";
+		}
+		std::cout << "\n";
+	}
+
+	// ---- results ----
+
+	static double percentile(std::vector<double> values, double p) {
+		if (values.empty()) return 0.0;
+
+		std::sort(values.begin(), values.end());
+		auto rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+		return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+	}
+
+	static void writeStats(std::ostream& out, const std::vector<double>& values) {
+		double mean = 0.0;
+		for (auto value : values) mean += value;
+		if (!values.empty()) mean /= values.size();
+
+		out << "{\"mean\": " << mean
+			<< ", \"p50\": " << percentile(values, 50.0)
+			<< ", \"p95\": " << percentile(values, 95.0)
+			<< ", \"p99\": " << percentile(values, 99.0)
+			<< ", \"samples\": " << values.size() << "}";
+	}
+
+	void writeResults(std::ostream& out) {
+		auto properties = physicalDevice.getProperties();
+
+		out << "{\n";
+		out << "\t\"device\": \"" << properties.deviceName.data() << "\",\n";
+		out << "\t\"width\": " << swapChainExtent.width << ",\n";
+		out << "\t\"height\": " << swapChainExtent.height << ",\n";
+		out << "\t\"frames\": " << settings.headlessFrames << ",\n";
+		out << "\t\"record_threads\": " << commandRecorder.getThreadCount() << ",\n";
+		out << "\t\"scenes\": [\n";
+
+		for (size_t i = 0; i < scenes.size(); i++) {
+			auto& scene = scenes[i];
+
+			out << "\t\t{\n";
+			out << "\t\t\t\"name\": \"" << scene.name << "\",\n";
+			out << "\t\t\t\"triangles\": " << scene.indices.size() / 3 << ",\n";
+			out << "\t\t\t\"draws\": " << scene.draws << ",\n";
+			out << "\t\t\t\"cpu_frame_ms\": ";
+			writeStats(out, scene.cpuFrameMs);
+			out << ",\n\t\t\t\"gpu_frame_ms\": ";
+			writeStats(out, scene.gpuFrameMs);
+			out << ",\n\t\t\t\"record_ms\": ";
+			writeStats(out, scene.recordMs);
+			out << ",\n\t\t\t\"visible_draws\": ";
+			writeStats(out, scene.visibleDraws);
+			out << ",\n\t\t\t\"fps\": " << (scene.seconds > 0.0 ? scene.cpuFrameMs.size() / scene.seconds : 0.0) << "\n";
+			out << "\t\t}" << (i + 1 < scenes.size() ? "," : "") << "\n";
+		}
+
+		out << "\t]\n";
+		out << "}\n";
+	}
+
+	void writeResults() {
+		writeResults(std::cout);
+
+		if (!settings.outputPath.empty()) {
+			std::ofstream file(settings.outputPath, std::ios::trunc);
+			if (!file.is_open()) {
+				std::cout << "benchmark : failed to open " << settings.outputPath << "\n";
+				return;
+			}
+			writeResults(file);
+		}
+	}
+
+	// ---- setup ----
+
+	void prepare() {
+		createUniformBuffers();
+		createDescriptorSets();
+
+		createRenderGraph();
+
+		trianglePipelineLayout = device.createPipelineLayout({});
+		uniformPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+			.setLayoutCount = 1,
+			.pSetLayouts = &descriptorSetLayout,
+		});
+
+		vk::PushConstantRange transformRange{
+			.stageFlags = vk::ShaderStageFlagBits::eVertex,
+			.offset = 0,
+			.size = sizeof(VEdrawMvp),
+		};
+		pushPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &transformRange,
+		});
+
+		trianglePipeline = createPipeline("triangle/triangle", trianglePipelineLayout);
+		uniformPipeline = createPipeline("uniform/uniform", uniformPipelineLayout);
+		// shaders/push가 compile 되어 있지 않으면 push / cull scene을 건너뛴다 (빈 handle은 destroy 해도 된다)
+		pushEnabled = hasShader("push/push.vert.spv");
+		if (pushEnabled) {
+			pushPipeline = createPipeline("push/push", pushPipelineLayout, "uniform/uniform");
+		}
+
+		// drawIndirectCount가 없으면 VEgpuCuller가 drawIndexedIndirect로 그린다
+		// shaders/gpuculling이 compile 되어 있지 않으면 push scene처럼 gpu scene을 건너뛴다
+		gpuCullShaders = hasShader("gpuculling/cull.comp.spv") && hasShader("gpuculling/gpuculling.vert.spv");
+		gpuCullEnabled = VEgpuCuller::isSupported(enabledFeatures) && gpuCullShaders;
+		if (gpuCullEnabled) {
+			auto shaderCode = readFileAsBinary(getShadersPath() + "gpuculling/cull.comp.spv");
+			gpuCuller.init(device, allocator, pipelineCache, framesInFlight, shaderCode, enabledFeatures.drawIndirectCount,
+				capabilities.properties.limits.maxDrawIndirectCount);
+			// scene을 바꿀 때 이전 object buffer는 사용중인 frame이 끝난 뒤 파괴한다
+			gpuCuller.setRetire([this](std::function<void()> destroy) { retire(std::move(destroy)); });
+
+			vk::PushConstantRange drawRange{
+				.stageFlags = vk::ShaderStageFlagBits::eVertex,
+				.offset = 0,
+				.size = sizeof(GpuDrawConstants),
+			};
+			auto gpuSetLayout = gpuCuller.getSetLayout();
+			gpuPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+				.setLayoutCount = 1,
+				.pSetLayouts = &gpuSetLayout,
+				.pushConstantRangeCount = 1,
+				.pPushConstantRanges = &drawRange,
+			});
+			gpuPipeline = createPipeline("gpuculling/gpuculling", gpuPipelineLayout, "uniform/uniform");
+		}
+
+		if (postEnabled) {
+			postPipeline = createPostPipeline(renderGraph.getRenderPass(vignettePass));
+			presentPipeline = createPostPipeline(renderGraph.getRenderPass(presentPass));
+		}
+
+		createFrameBuffers();
+		renderGraph.printStats(std::cout);
+
+		// present 용 semaphore는 base가 image 마다 만든다 (presentReadySemaphores)
+		renderSemaphores.resize(framesInFlight);
+
+		for (auto i = 0; i < framesInFlight; i++) {
+			renderSemaphores[i] = device.createSemaphore({});
+		}
+	}
+
+	// depth attachment는 D32가 없으면 반드시 지원되는 D16으로
+	vk::Format findDepthFormat() const {
+		auto properties = physicalDevice.getFormatProperties(vk::Format::eD32Sfloat);
+		if (properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment) {
+			return vk::Format::eD32Sfloat;
+		}
+		return vk::Format::eD16Unorm;
+	}
+
+	// scene은 중간 color target에 그리고 vignette / present pass를 거쳐 backbuffer로 나간다.
+	// sceneDepth는 scene pass에서 끝나므로 vignette pass가 쓰는 postColor와 메모리를 공유한다 (aliasing)
+	void createRenderGraph() {
+		backbuffer = renderGraph.importBackbuffer("backbuffer", swapChainFormat, getPresentLayout());
+		sceneDepth = renderGraph.createImage("sceneDepth", { .format = findDepthFormat() });
+
+		postEnabled = hasShader("post/post.vert.spv") && hasShader("post/post.frag.spv");
+		if (postEnabled) {
+			sceneColor = renderGraph.createImage("sceneColor", { .format = vk::Format::eR8G8B8A8Unorm });
+			postColor = renderGraph.createImage("postColor", { .format = vk::Format::eR8G8B8A8Unorm });
+		}
+		else {
+			std::cout << "benchmark : post/post.vert.spv or post.frag.spv not found (compile shaders/post), scene pass draws to the backbuffer\n";
+		}
+
+		vk::ClearValue clearValue;
+		clearValue.color = { 0.0f, 0.0f, 0.1f, 1.0f };
+		vk::ClearValue depthClear;
+		depthClear.depthStencil = { 1.0f, 0 };
+
+		scenePass = renderGraph.addParallelPass("scene", [this](vk::CommandBuffer commandBuffer, const vk::CommandBufferInheritanceInfo& inheritance) {
+			drawScene(commandBuffer, inheritance);
+		});
+		renderGraph.writeColor(scenePass, postEnabled ? sceneColor : backbuffer, clearValue);
+		renderGraph.writeDepth(scenePass, sceneDepth, depthClear);
+
+		if (postEnabled) {
+			vignettePass = renderGraph.addPass("vignette", [this](vk::CommandBuffer commandBuffer) {
+				drawPost(commandBuffer, vignettePass, postPipeline, sceneColor, 0.6f);
+			});
+			renderGraph.readTexture(vignettePass, sceneColor);
+			renderGraph.writeColor(vignettePass, postColor);
+
+			presentPass = renderGraph.addPass("present", [this](vk::CommandBuffer commandBuffer) {
+				drawPost(commandBuffer, presentPass, presentPipeline, postColor, 0.0f);
+			});
+			renderGraph.readTexture(presentPass, postColor);
+			renderGraph.writeColor(presentPass, backbuffer);
+
+			// depth 확인용 (256x256). 결과를 markOutput 하지 않았으므로 compile에서 제거된다 (pass culling)
+			auto debugView = renderGraph.createImage("debugView", { .format = vk::Format::eR8G8B8A8Unorm, .extent = { 256, 256 } });
+			debugPass = renderGraph.addPass("depth debug", [this](vk::CommandBuffer commandBuffer) {
+				drawPost(commandBuffer, debugPass, postPipeline, sceneDepth, 0.0f);
+			});
+			renderGraph.readTexture(debugPass, sceneDepth);
+			renderGraph.writeColor(debugPass, debugView);
+		}
+
+		renderGraph.compile();
+
+		if (postEnabled) {
+			postSampler = device.createSampler(vk::SamplerCreateInfo{
+				.magFilter = vk::Filter::eNearest,
+				.minFilter = vk::Filter::eNearest,
+				.mipmapMode = vk::SamplerMipmapMode::eNearest,
+				.addressModeU = vk::SamplerAddressMode::eClampToEdge,
+				.addressModeV = vk::SamplerAddressMode::eClampToEdge,
+				.addressModeW = vk::SamplerAddressMode::eClampToEdge,
+				.maxLod = 0.0f,
+			});
+
+			vk::DescriptorSetLayoutBinding sourceBinding{
+				.binding = 0,
+				.descriptorType = vk::DescriptorType::eCombinedImageSampler,
+				.descriptorCount = 1,
+				.stageFlags = vk::ShaderStageFlagBits::eFragment,
+			};
+			postSetLayout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+				.bindingCount = 1,
+				.pBindings = &sourceBinding,
+			});
+			postTemplate.init(device, postSetLayout, {
+				{ .binding = 0, .type = vk::DescriptorType::eCombinedImageSampler },
+			});
+
+			vk::PushConstantRange postRange{
+				.stageFlags = vk::ShaderStageFlagBits::eFragment,
+				.offset = 0,
+				.size = sizeof(float),
+			};
+			postPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+				.setLayoutCount = 1,
+				.pSetLayouts = &postSetLayout,
+				.pushConstantRangeCount = 1,
+				.pPushConstantRanges = &postRange,
+			});
+		}
+	}
+
+	void createUniformBuffers() {
+		uniformData.resize(framesInFlight);
+
+		for (auto i = 0; i < framesInFlight; i++) {
+			createBuffer(sizeof(UniformBufferObject),
+				vk::BufferUsageFlagBits::eUniformBuffer,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+				uniformData[i].buffer, uniformData[i].allocation);
+		}
+	}
+
+	void createDescriptorSets() {
+		vk::DescriptorSetLayoutBinding uboLayoutBinding{
+			.binding = 0,
+			.descriptorType = vk::DescriptorType::eUniformBuffer,
+			.descriptorCount = 1,
+			.stageFlags = vk::ShaderStageFlagBits::eVertex,
+		};
+
+		descriptorSetLayout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+			.bindingCount = 1,
+			.pBindings = &uboLayoutBinding,
+		});
+
+		descriptorTemplate.init(device, descriptorSetLayout, {
+			{ .binding = 0, .type = vk::DescriptorType::eUniformBuffer },
+		});
+
+		descriptorSets.resize(framesInFlight);
+	}
+
+	// per-frame set : slot의 pool은 beginFrame에서 reset 되므로 free 하지 않는다
+	void updateDescriptorSet(uint32_t frameIndex) {
+		descriptorSets[frameIndex] = frameDescriptors.allocate(descriptorSetLayout);
+
+		vk::DescriptorBufferInfo bufferInfo{
+			.buffer = uniformData[frameIndex].buffer,
+			.offset = 0,
+			.range = sizeof(UniformBufferObject),
+		};
+		descriptorTemplate.update(descriptorSets[frameIndex], bufferInfo);
+	}
+
+	// triangle / uniform 예제의 shader를 그대로 사용한다 (vertex 형식이 같다)
+	// fragShader : vertex shader와 다른 fragment shader를 쓸 때
+	vk::Pipeline createPipeline(const std::string& shader, vk::PipelineLayout layout, const std::string& fragShader = {}) {
+		auto vert = readFileAsBinary(getShadersPath() + shader + ".vert.spv");
+		auto frag = readFileAsBinary(getShadersPath() + (fragShader.empty() ? shader : fragShader) + ".frag.spv");
+
+		auto vertModule = createShaderModule(vert);
+		auto fragModule = createShaderModule(frag);
+
+		vk::PipelineShaderStageCreateInfo shaderStages[]{
+			{
+				.stage = vk::ShaderStageFlagBits::eVertex,
+				.module = vertModule,
+				.pName = "main",
+			},
+			{
+				.stage = vk::ShaderStageFlagBits::eFragment,
+				.module = fragModule,
+				.pName = "main",
+			}
+		};
+
+		vk::PipelineVertexInputStateCreateInfo vertexInputState{
+			.vertexBindingDescriptionCount = 1,
+			.pVertexBindingDescriptions = &binding,
+			.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size()),
+			.pVertexAttributeDescriptions = attributes.data(),
+		};
+
+		vk::PipelineInputAssemblyStateCreateInfo inputAssembly{
+			.topology = vk::PrimitiveTopology::eTriangleList,
+			.primitiveRestartEnable = vk::False,
+		};
+
+		vk::PipelineViewportStateCreateInfo viewportState{
+			.viewportCount = 1,
+			.scissorCount = 1,
+		};
+
+		// camera가 평면 양쪽을 모두 돌기 때문에 culling 하지 않는다
+		vk::PipelineRasterizationStateCreateInfo rasterizer{
+			.depthClampEnable = vk::False,
+			.rasterizerDiscardEnable = vk::False,
+			.polygonMode = vk::PolygonMode::eFill,
+			.cullMode = vk::CullModeFlagBits::eNone,
+			.frontFace = vk::FrontFace::eCounterClockwise,
+			.depthBiasEnable = vk::False,
+			.lineWidth = 1.0f,
+		};
+
+		vk::PipelineMultisampleStateCreateInfo multisampling{
+			.rasterizationSamples = vk::SampleCountFlagBits::e1,
+			.sampleShadingEnable = vk::False,
+		};
+
+		// quad는 모두 z = 0 평면에 있으므로 같은 깊이면 나중에 그린 것이 보인다 (depth 없을 때와 같은 결과)
+		vk::PipelineDepthStencilStateCreateInfo depthStencil{
+			.depthTestEnable = vk::True,
+			.depthWriteEnable = vk::True,
+			.depthCompareOp = vk::CompareOp::eLessOrEqual,
+		};
+
+		vk::PipelineColorBlendAttachmentState colorBlendAttachment{
+			.blendEnable = vk::False,
+			.colorWriteMask = vk::ColorComponentFlagBits::eR |
+							vk::ColorComponentFlagBits::eG |
+							vk::ColorComponentFlagBits::eB |
+							vk::ColorComponentFlagBits::eA,
+		};
+
+		vk::PipelineColorBlendStateCreateInfo colorBlendState{
+			.logicOpEnable = vk::False,
+			.attachmentCount = 1,
+			.pAttachments = &colorBlendAttachment,
+		};
+
+		vk::DynamicState dynamicStates[2] = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+		vk::PipelineDynamicStateCreateInfo dynamicState{
+			.dynamicStateCount = 2,
+			.pDynamicStates = dynamicStates,
+		};
+
+		vk::GraphicsPipelineCreateInfo pipelineInfo{
+			.stageCount = 2,
+			.pStages = shaderStages,
+			.pVertexInputState = &vertexInputState,
+			.pInputAssemblyState = &inputAssembly,
+			.pViewportState = &viewportState,
+			.pRasterizationState = &rasterizer,
+			.pMultisampleState = &multisampling,
+			.pDepthStencilState = &depthStencil,
+			.pColorBlendState = &colorBlendState,
+			.pDynamicState = &dynamicState,
+			.layout = layout,
+			.renderPass = renderGraph.getRenderPass(scenePass),
+			.subpass = 0,
+		};
+
+		auto pipeline = pipelineCache.createGraphicsPipeline(pipelineInfo);
+
+		device.destroyShaderModule(vertModule);
+		device.destroyShaderModule(fragModule);
+
+		return pipeline;
+	}
+
+	// 화면 전체 삼각형 하나로 이전 pass 결과를 읽는다 (vertex input / depth 없음)
+	vk::Pipeline createPostPipeline(vk::RenderPass renderPass) {
+		auto vert = readFileAsBinary(getShadersPath() + "post/post.vert.spv");
+		auto frag = readFileAsBinary(getShadersPath() + "post/post.frag.spv");
+
+		auto vertModule = createShaderModule(vert);
+		auto fragModule = createShaderModule(frag);
+
+		vk::PipelineShaderStageCreateInfo shaderStages[]{
+			{
+				.stage = vk::ShaderStageFlagBits::eVertex,
+				.module = vertModule,
+				.pName = "main",
+			},
+			{
+				.stage = vk::ShaderStageFlagBits::eFragment,
+				.module = fragModule,
+				.pName = "main",
+			}
+		};
+
+		vk::PipelineVertexInputStateCreateInfo vertexInputState{};
+
+		vk::PipelineInputAssemblyStateCreateInfo inputAssembly{
+			.topology = vk::PrimitiveTopology::eTriangleList,
+			.primitiveRestartEnable = vk::False,
+		};
+
+		vk::PipelineViewportStateCreateInfo viewportState{
+			.viewportCount = 1,
+			.scissorCount = 1,
+		};
+
+		vk::PipelineRasterizationStateCreateInfo rasterizer{
+			.depthClampEnable = vk::False,
+			.rasterizerDiscardEnable = vk::False,
+			.polygonMode = vk::PolygonMode::eFill,
+			.cullMode = vk::CullModeFlagBits::eNone,
+			.frontFace = vk::FrontFace::eCounterClockwise,
+			.depthBiasEnable = vk::False,
+			.lineWidth = 1.0f,
+		};
+
+		vk::PipelineMultisampleStateCreateInfo multisampling{
+			.rasterizationSamples = vk::SampleCountFlagBits::e1,
+			.sampleShadingEnable = vk::False,
+		};
+
+		vk::PipelineColorBlendAttachmentState colorBlendAttachment{
+			.blendEnable = vk::False,
+			.colorWriteMask = vk::ColorComponentFlagBits::eR |
+							vk::ColorComponentFlagBits::eG |
+							vk::ColorComponentFlagBits::eB |
+							vk::ColorComponentFlagBits::eA,
+		};
+
+		vk::PipelineColorBlendStateCreateInfo colorBlendState{
+			.logicOpEnable = vk::False,
+			.attachmentCount = 1,
+			.pAttachments = &colorBlendAttachment,
+		};
+
+		vk::DynamicState dynamicStates[2] = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+		vk::PipelineDynamicStateCreateInfo dynamicState{
+			.dynamicStateCount = 2,
+			.pDynamicStates = dynamicStates,
+		};
+
+		vk::GraphicsPipelineCreateInfo pipelineInfo{
+			.stageCount = 2,
+			.pStages = shaderStages,
+			.pVertexInputState = &vertexInputState,
+			.pInputAssemblyState = &inputAssembly,
+			.pViewportState = &viewportState,
+			.pRasterizationState = &rasterizer,
+			.pMultisampleState = &multisampling,
+			.pColorBlendState = &colorBlendState,
+			.pDynamicState = &dynamicState,
+			.layout = postPipelineLayout,
+			.renderPass = renderPass,
+			.subpass = 0,
+		};
+
+		auto pipeline = pipelineCache.createGraphicsPipeline(pipelineInfo);
+
+		device.destroyShaderModule(vertModule);
+		device.destroyShaderModule(fragModule);
+
+		return pipeline;
+	}
+
+	virtual void createFrameBuffers() {
+		renderGraph.setBackbuffer(swapChainImages, swapChainImageViews, swapChainExtent);
+	}
+
+	virtual void destroyFrameBuffers() {
+		renderGraph.releaseTargets();
+	}
+
+	// ---- frame ----
+
+	// frame 번호로 camera 궤도 위치를 정한다 (scene 당 한 바퀴)
+	UniformBufferObject computeCamera() {
+		float t = static_cast<float>(sceneFrame) / (WARMUP_FRAMES + settings.headlessFrames);
+		float angle = t * glm::two_pi<float>();
+		float distance = currentScene->cameraDistance;
+
+		UniformBufferObject ubo{
+			.model = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f)),
+			.view = glm::lookAt(glm::vec3(distance * std::cos(angle), distance * std::sin(angle), distance * 0.6f),
+				glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
+			.proj = glm::perspective(glm::radians(45.0f), swapChainExtent.width / (float)swapChainExtent.height, 0.1f, 100.0f),
+		};
+
+		// GLM's Y coord. of the clip coord. is inverted
+		ubo.proj[1][1] *= -1;
+
+		sceneAngle = angle;
+		return ubo;
+	}
+
+	void updateUniformBuffer(uint32_t frameIndex) {
+		VE_PROFILE_FUNCTION();
+
+		auto ubo = computeCamera();
+		memcpy(uniformData[frameIndex].allocation.mapped, &ubo, sizeof(ubo));
+	}
+
+	// push scene : UBO를 쓰지 않고 camera만 곱해 둔다
+	void updateCamera() {
+		auto camera = computeCamera();
+		viewProj = camera.proj * camera.view;
+		sceneModel = camera.model;
+	}
+
+	// quad 중심을 기준으로 돈다 (object 마다 다른 model 행렬)
+	glm::mat4 getObjectModel(uint32_t draw) const {
+		glm::vec3 center{ currentScene->centers[draw], 0.0f };
+		float spin = sceneAngle * 4.0f + draw * 0.01f;
+
+		return sceneModel * glm::translate(glm::mat4(1.0f), center) *
+			glm::rotate(glm::mat4(1.0f), spin, glm::vec3(0.0f, 0.0f, 1.0f)) * glm::translate(glm::mat4(1.0f), -center);
+	}
+
+	// scene의 draw를 thread 별 secondary command buffer로 나눠 기록한다
+	void drawScene(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance) {
+		auto indicesPerDraw = static_cast<uint32_t>(currentScene->indices.size()) / currentScene->draws;
+		auto visible = currentScene->cull ? culler.getVisible() : nullptr;
+
+		// gpu scene : draw 수와 관계없이 indirect draw 한 번 (draw command는 compute pass가 채운다)
+		auto recordCount = currentScene->gpuCull ? 1u : drawCount;
+
+		commandRecorder.recordParallel(primary, inheritance, recordCount,
+			[&](vk::CommandBuffer commandBuffer, uint32_t thread, uint32_t first, uint32_t count) {
+				bindScene(commandBuffer);
+
+				if (currentScene->gpuCull) {
+					gpuCuller.draw(commandBuffer, currentFrame);
+					return;
+				}
+
+				for (uint32_t i = first; i < first + count; i++) {
+					auto draw = visible ? visible[i] : i;
+					if (currentScene->pushTransform) {
+						// MVP는 object 당 한 번 CPU에서 곱한다 (vertex shader는 행렬 하나만 곱한다)
+						auto transform = makeDrawMvp(viewProj, getObjectModel(draw));
+						commandBuffer.pushConstants(pushPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(transform), &transform);
+					}
+					commandBuffer.drawIndexed(indicesPerDraw, 1, draw * indicesPerDraw, 0, 0);
+				}
+			});
+	}
+
+	// source : 이전 pass가 쓴 image (graph가 eShaderReadOnlyOptimal로 옮겨 둔다)
+	// set은 image view가 swapchain 재생성 때 바뀌므로 frame 마다 frameDescriptors에서 할당한다
+	void drawPost(vk::CommandBuffer commandBuffer, uint32_t pass, vk::Pipeline pipeline, uint32_t source, float vignette) {
+		auto extent = renderGraph.getPassExtent(pass);
+
+		commandBuffer.setViewport(0, vk::Viewport{
+			.x = 0,
+			.y = 0,
+			.width = (float)extent.width,
+			.height = (float)extent.height,
+			.minDepth = 0.0f,
+			.maxDepth = 1.0f,
+			});
+
+		commandBuffer.setScissor(0, vk::Rect2D{
+			.offset = {0, 0},
+			.extent = extent,
+			});
+
+		auto descriptorSet = frameDescriptors.allocate(postSetLayout);
+		vk::DescriptorImageInfo imageInfo{
+			.sampler = postSampler,
+			.imageView = renderGraph.getImageView(source),
+			.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+		};
+		postTemplate.update(descriptorSet, imageInfo);
+
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, postPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+		commandBuffer.pushConstants(postPipelineLayout, vk::ShaderStageFlagBits::eFragment, 0, sizeof(vignette), &vignette);
+		commandBuffer.draw(3, 1, 0, 0);
+	}
+
+	// secondary command buffer는 state를 물려받지 않으므로 각자 설정한다
+	void bindScene(vk::CommandBuffer commandBuffer) {
+		auto extent = renderGraph.getPassExtent(scenePass);
+
+		commandBuffer.setViewport(0, vk::Viewport{
+			.x = 0,
+			.y = 0,
+			.width = (float)extent.width,
+			.height = (float)extent.height,
+			.minDepth = 0.0f,
+			.maxDepth = 1.0f,
+			});
+
+		commandBuffer.setScissor(0, vk::Rect2D{
+			.offset = {0, 0},
+			.extent = extent,
+			});
+
+		if (currentScene->gpuCull) {
+			GpuDrawConstants constants{
+				.viewProjModel = viewProj * sceneModel,
+				.angle = sceneAngle,
+			};
+			auto descriptorSet = gpuCuller.getDescriptorSet(currentFrame);
+
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, gpuPipeline);
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, gpuPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+			commandBuffer.pushConstants(gpuPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(constants), &constants);
+		}
+		else if (currentScene->pushTransform) {
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pushPipeline);
+		}
+		else if (currentScene->useUniform) {
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, uniformPipeline);
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, uniformPipelineLayout, 0, 1, &descriptorSets[currentFrame], 0, nullptr);
+		}
+		else {
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, trianglePipeline);
+		}
+
+		vk::DeviceSize offsets[]{ 0 };
+		commandBuffer.bindVertexBuffers(0, vertexBuffer, offsets);
+		commandBuffer.bindIndexBuffer(indexBuffer, 0, vk::IndexType::eUint32);
+	}
+
+	void recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex) {
+		vk::CommandBufferBeginInfo beginInfo{};
+		commandBuffer.begin(beginInfo);
+
+		gpuProfiler.beginFrame(commandBuffer, currentFrame);
+
+		// compute pass는 renderpass 밖에서 scene pass 보다 먼저
+		if (currentScene->gpuCull) {
+			VEgpuZone zone(gpuProfiler, commandBuffer, "gpu cull");
+			gpuCuller.cull(commandBuffer, currentFrame, gpuFrustum);
+		}
+
+		renderGraph.execute(commandBuffer, imageIndex);
+
+		commandBuffer.end();
+	}
+
+	void drawFrame() {
+		currentFrame = beginFrame();
+
+		uint32_t imageIndex{};
+		std::ignore = acquireNextImage(renderSemaphores[currentFrame], imageIndex);
+
+		auto commandBuffer = commandRecorder.beginFrame(currentFrame);
+		if (gpuCullEnabled) {
+			gpuCuller.beginFrame(currentFrame);
+		}
+
+		if (currentScene->useUniform) {
+			updateUniformBuffer(currentFrame);
+			updateDescriptorSet(currentFrame);
+		}
+		else if (currentScene->pushTransform || currentScene->gpuCull) {
+			updateCamera();
+		}
+
+		drawCount = currentScene->draws;
+		if (currentScene->cull) {
+			VE_PROFILE_ZONE("cull");
+			// bounds는 scene model 공간에 있으므로 model까지 곱한 행렬의 frustum과 비교한다
+			culler.cull(&jobs, VEfrustum::fromMatrix(viewProj * sceneModel), currentScene->bounds);
+			drawCount = culler.getVisibleCount();
+		}
+		else if (currentScene->gpuCull) {
+			// framesInFlight frame 전에 이 slot에서 cull 한 결과 (beginFrame에서 끝난 것을 기다렸다)
+			drawCount = gpuCuller.getVisibleCount(currentFrame);
+			gpuFrustum = VEfrustum::fromMatrix(viewProj * sceneModel);
+		}
+
+		recordCommandBuffer(commandBuffer, imageIndex);
+
+		submitFrame(commandBuffer, renderSemaphores[currentFrame], presentReadySemaphores[imageIndex]);
+		std::ignore = presentImage(presentReadySemaphores[imageIndex], imageIndex);
+	}
+};
+
+int main(int argc, char** argv) {
+	// 비교 가능한 숫자를 위해 항상 headless로 실행한다
+	auto settings = parseSettings(argc, argv);
+	settings.headless = true;
+
+	auto app = new Benchmark(settings);
+	app->run();
+	delete app;
+
+	return EXIT_SUCCESS;
+}
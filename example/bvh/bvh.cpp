@@ -0,0 +1,364 @@
+#include "VEbase.h"
+#include "VEbvh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+
+// BVH (base/VEbvh.h) 측정 (Vulkan device는 만들지 않는다)
+// [-100, 100]^3 안에 무작위로 흩어진 object의 AABB로
+//	build		: binned SAH build 시간, node 수, depth, SAH cost
+//	frustum		: queryFrustum과 VEculler (모든 object를 SIMD로 검사)의 시간 비교, 결과 개수 확인
+//	picking		: 화면 위 무작위 점을 지나는 ray의 가장 가까운 object (raycast와 전체 검사 비교)
+//	refit		: 10% object를 움직였을 때 update (object 마다)와 setBounds + refit (한 번에)
+//	insert		: 10% object를 remove 후 다시 insert, rebuild 전후의 SAH cost
+// update / refit / remove / insert / rebuild 뒤에는 frustum, box, sphere, ray query를
+// object 전체를 검사한 결과와 비교한다 (verify, 시간 측정에는 들어가지 않는다).
+//
+//	bvh --threads 8
+class BvhBenchmark {
+public:
+	BvhBenchmark(const VEsettings& settings) {
+		jobs.init(settings.threads);
+	}
+
+	~BvhBenchmark() {
+		jobs.cleanUp();
+	}
+
+	void run() {
+		proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+		proj[1][1] *= -1;
+		view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.1f), glm::vec3(0.0f, 0.0f, 1.0f));
+		frustum = VEfrustum::fromMatrix(proj * view);
+
+		for (uint32_t count : { 64u * 1024, 1024u * 1024 }) {
+			std::cout << "bvh : " << count << " objects\n";
+
+			createObjects(count);
+			measureBuild();
+			measureFrustum();
+			measurePicking();
+			measureRefit();
+			measureInsert();
+		}
+	}
+private:
+	using Clock = std::chrono::high_resolution_clock;
+
+	static constexpr uint32_t ROUNDS = 10;
+	static constexpr uint32_t RAYS = 1000;
+	static constexpr uint32_t LINEAR_RAYS = 20;	// 전체 검사는 느리므로 일부 ray만
+	static constexpr uint32_t VERIFY_QUERIES = 20;	// verify 마다 box / sphere query 수
+
+	VEjobSystem jobs;
+	std::mt19937 random{ 1 };
+
+	glm::mat4 proj, view;
+	VEfrustum frustum{};
+
+	std::vector<VEaabb> bounds;
+	std::vector<VEaabb> expected;	// object id -> 지금 bvh에 있어야 하는 bound (지운 id는 비어 있다)
+	VEboxBounds boxes;
+	VEbvh bvh;
+	VEculler culler;
+
+	static double elapsedMs(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	template <typename Func>
+	static double measure(Func func) {
+		double best = std::numeric_limits<double>::max();
+
+		for (uint32_t round = 0; round < ROUNDS; round++) {
+			auto start = Clock::now();
+			func();
+			best = std::min(best, elapsedMs(start));
+		}
+
+		return best;
+	}
+
+	void createObjects(uint32_t count) {
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> radius(0.5f, 2.0f);
+
+		bounds.resize(count);
+		boxes.clear();
+		for (auto& box : bounds) {
+			glm::vec3 center{ position(random), position(random), position(random) };
+			float r = radius(random);
+
+			box = VEaabb{ .min = center - r, .max = center + r };
+			boxes.add(box.min, box.max);
+		}
+	}
+
+	void measureBuild() {
+		auto start = Clock::now();
+		bvh.build(bounds);
+		auto buildMs = elapsedMs(start);
+		expected = bounds;
+
+		std::cout << "\tbuild : " << buildMs << " ms\n\t";
+		bvh.printStats(std::cout);
+	}
+
+	void measureFrustum() {
+		std::vector<uint32_t> visible;
+
+		auto bvhMs = measure([&] {
+			visible.clear();
+			bvh.queryFrustum(frustum, visible);
+		});
+		auto linearMs = measure([&] {
+			culler.cull(nullptr, frustum, boxes);
+		});
+		auto parallelMs = measure([&] {
+			culler.cull(&jobs, frustum, boxes);
+		});
+
+		std::cout << "\tfrustum : visible " << visible.size() << ", bvh " << bvhMs << " ms, linear simd " << linearMs
+			<< " ms, linear parallel " << parallelMs << " ms";
+		if (visible.size() != culler.getVisibleCount()) {
+			std::cout << " (mismatch : linear " << culler.getVisibleCount() << ")";
+		}
+		std::cout << "\n";
+	}
+
+	// 화면의 점을 지나는 camera ray (camera는 원점)
+	std::vector<glm::vec3> createPickRays(uint32_t count) {
+		std::uniform_real_distribution<float> screen(-1.0f, 1.0f);
+		auto inverse = glm::inverse(proj * view);
+
+		std::vector<glm::vec3> directions(count);
+		for (auto& direction : directions) {
+			auto point = inverse * glm::vec4(screen(random), screen(random), 1.0f, 1.0f);
+			direction = glm::normalize(glm::vec3(point) / point.w);
+		}
+		return directions;
+	}
+
+	VEbvhHit raycastLinear(const glm::vec3& origin, const glm::vec3& direction) const {
+		VEbvhHit hit{};
+		auto inverse = 1.0f / direction;
+
+		for (uint32_t i = 0; i < expected.size(); i++) {
+			if (expected[i].isEmpty()) continue;
+
+			auto t0 = (expected[i].min - origin) * inverse;
+			auto t1 = (expected[i].max - origin) * inverse;
+			auto near = glm::min(t0, t1);
+			auto far = glm::max(t0, t1);
+
+			auto entry = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+			auto exit = std::min(std::min(far.x, far.y), far.z);
+			if (entry <= exit && entry < hit.distance) {
+				hit = VEbvhHit{ .object = i, .distance = entry };
+			}
+		}
+
+		return hit;
+	}
+
+	void measurePicking() {
+		auto rays = createPickRays(RAYS);
+		glm::vec3 origin{ 0.0f };
+
+		uint32_t hits = 0;
+		auto start = Clock::now();
+		for (auto& direction : rays) {
+			hits += bvh.raycast(origin, direction).object != VEbvh::INVALID;
+		}
+		auto bvhUs = elapsedMs(start) * 1000.0 / RAYS;
+
+		uint32_t mismatches = 0;
+		start = Clock::now();
+		for (uint32_t i = 0; i < LINEAR_RAYS; i++) {
+			auto linear = raycastLinear(origin, rays[i]);
+			auto hit = bvh.raycast(origin, rays[i]);
+			mismatches += linear.object != hit.object && linear.distance != hit.distance;
+		}
+		auto linearUs = elapsedMs(start) * 1000.0 / LINEAR_RAYS - bvhUs;
+
+		std::cout << "\tpicking : " << hits << " / " << RAYS << " hit, bvh " << bvhUs << " us / ray, linear " << linearUs << " us / ray";
+		if (mismatches) {
+			std::cout << " (" << mismatches << " mismatches)";
+		}
+		std::cout << "\n";
+	}
+
+	// 10% object를 조금씩 움직인다
+	std::vector<uint32_t> moveObjects() {
+		std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+		std::vector<uint32_t> moved;
+
+		for (uint32_t i = 0; i < bounds.size(); i += 10) {
+			glm::vec3 delta{ offset(random), offset(random), offset(random) };
+			bounds[i].min += delta;
+			bounds[i].max += delta;
+			moved.push_back(i);
+		}
+		return moved;
+	}
+
+	// build 이후 remove 전까지는 object id가 bounds 번호와 같다
+	void measureRefit() {
+		auto moved = moveObjects();
+		auto start = Clock::now();
+		for (auto object : moved) {
+			bvh.update(object, bounds[object]);
+		}
+		auto updateMs = elapsedMs(start);
+		expected = bounds;
+		verify("update");
+
+		moved = moveObjects();
+		start = Clock::now();
+		for (auto object : moved) {
+			bvh.setBounds(object, bounds[object]);
+		}
+		bvh.refit();
+		auto refitMs = elapsedMs(start);
+		expected = bounds;
+		verify("refit");
+
+		std::cout << "\trefit : " << moved.size() << " moved, update " << updateMs << " ms, setBounds + refit " << refitMs
+			<< " ms, SAH cost " << bvh.getSAHCost() << "\n";
+	}
+
+	void measureInsert() {
+		auto count = static_cast<uint32_t>(bounds.size() / 10);
+
+		auto start = Clock::now();
+		for (uint32_t object = 0; object < count; object++) {
+			bvh.remove(object);
+		}
+		auto removeUs = elapsedMs(start) * 1000.0 / count;
+
+		for (uint32_t object = 0; object < count; object++) {
+			expected[object] = VEaabb{};
+		}
+		verify("remove");
+
+		// 빈 id부터 다시 쓰므로 object 번호가 bounds와 달라질 수 있다 (돌려받은 id로 expected를 맞춘다)
+		std::vector<uint32_t> ids(count);
+		start = Clock::now();
+		for (uint32_t object = 0; object < count; object++) {
+			ids[object] = bvh.insert(bounds[object]);
+		}
+		auto insertUs = elapsedMs(start) * 1000.0 / count;
+		auto insertCost = bvh.getSAHCost();
+
+		for (uint32_t object = 0; object < count; object++) {
+			if (ids[object] >= expected.size()) {
+				expected.resize(ids[object] + 1);
+			}
+			expected[ids[object]] = bounds[object];
+		}
+		verify("insert");
+
+		start = Clock::now();
+		bvh.rebuild();
+		auto rebuildMs = elapsedMs(start);
+		verify("rebuild");
+
+		std::cout << "\tinsert : " << count << " objects, remove " << removeUs << " us, insert " << insertUs
+			<< " us, SAH cost " << insertCost << " -> " << bvh.getSAHCost() << " after rebuild (" << rebuildMs << " ms)\n";
+	}
+
+	static std::vector<uint32_t> sorted(std::vector<uint32_t> values) {
+		std::sort(values.begin(), values.end());
+		return values;
+	}
+
+	// 같은 판정식 (VEbvh의 leaf 검사)으로 expected 전체를 검사한 결과와 query 결과가 같은지 확인한다
+	void verify(const char* stage) {
+		uint32_t mismatches = 0;
+		std::vector<uint32_t> result, linear;
+
+		// object 수
+		uint32_t alive = 0;
+		for (auto& box : expected) {
+			alive += !box.isEmpty();
+		}
+		mismatches += alive != bvh.getObjectCount();
+
+		// frustum : VEculler (VEboxBounds)와 비교
+		VEboxBounds liveBoxes;
+		std::vector<uint32_t> liveIds;
+		for (uint32_t id = 0; id < expected.size(); id++) {
+			if (expected[id].isEmpty()) continue;
+			liveBoxes.add(expected[id].min, expected[id].max);
+			liveIds.push_back(id);
+		}
+		culler.cull(nullptr, frustum, liveBoxes);
+		for (uint32_t i = 0; i < culler.getVisibleCount(); i++) {
+			linear.push_back(liveIds[culler.getVisible()[i]]);
+		}
+		bvh.queryFrustum(frustum, result);
+		mismatches += sorted(result) != sorted(linear);
+
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> size(1.0f, 20.0f);
+
+		for (uint32_t query = 0; query < VERIFY_QUERIES; query++) {
+			glm::vec3 center{ position(random), position(random), position(random) };
+			float half = size(random);
+
+			// box
+			VEaabb box{ .min = center - half, .max = center + half };
+			linear.clear();
+			for (uint32_t id = 0; id < expected.size(); id++) {
+				auto& other = expected[id];
+				if (!other.isEmpty() && glm::all(glm::lessThanEqual(other.min, box.max)) && glm::all(glm::greaterThanEqual(other.max, box.min))) {
+					linear.push_back(id);
+				}
+			}
+			result.clear();
+			bvh.queryBox(box, result);
+			mismatches += sorted(result) != sorted(linear);
+
+			// sphere (AABB까지의 거리)
+			linear.clear();
+			for (uint32_t id = 0; id < expected.size(); id++) {
+				auto& other = expected[id];
+				if (other.isEmpty()) continue;
+
+				auto d = glm::max(glm::max(other.min - center, center - other.max), glm::vec3(0.0f));
+				if (d.x * d.x + d.y * d.y + d.z * d.z <= half * half) {
+					linear.push_back(id);
+				}
+			}
+			result.clear();
+			bvh.querySphere(center, half, result);
+			mismatches += sorted(result) != sorted(linear);
+		}
+
+		// ray : 같은 거리의 다른 object는 맞은 것으로 본다
+		glm::vec3 origin{ 0.0f };
+		for (auto& direction : createPickRays(LINEAR_RAYS)) {
+			auto hit = bvh.raycast(origin, direction);
+			auto reference = raycastLinear(origin, direction);
+			mismatches += hit.object != reference.object && hit.distance != reference.distance;
+		}
+
+		std::cout << "\tverify " << stage << " : ";
+		if (mismatches) {
+			std::cout << mismatches << " mismatches\n";
+		}
+		else {
+			std::cout << "ok\n";
+		}
+	}
+};
+
+int main(int argc, char** argv) {
+	auto app = new BvhBenchmark(parseSettings(argc, argv));
+	app->run();
+	delete app;
+
+	return EXIT_SUCCESS;
+}
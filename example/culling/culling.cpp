@@ -0,0 +1,146 @@
+#include "VEbase.h"
+#include "VEculling.h"
+
+#include <chrono>
+#include <limits>
+#include <random>
+
+// frustum culling 처리량 측정 (Vulkan device는 만들지 않는다)
+// [-100, 100]^3 안에 무작위로 흩어진 object를 원점의 camera frustum과 비교한다.
+//	scalar		: VEfrustum::testSphere / testBox를 object 마다 호출
+//	simd		: cullSpheres / cullBoxes 한 thread
+//	parallel	: VEculler (job system, --threads)
+// 결과가 scalar와 같은지 확인하고, 가장 빠른 실행 기준으로 초당 검사 수 (M tests/s)를 출력한다.
+//
+//	culling --threads 8
+class CullingBenchmark {
+public:
+	CullingBenchmark(const VEsettings& settings) {
+		jobs.init(settings.threads);
+	}
+
+	~CullingBenchmark() {
+		jobs.cleanUp();
+	}
+
+	void run() {
+		auto proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+		proj[1][1] *= -1;
+		auto view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.1f), glm::vec3(0.0f, 0.0f, 1.0f));
+		frustum = VEfrustum::fromMatrix(proj * view);
+
+		std::cout << "culling : " << getCullingPath() << ", " << jobs.getWorkerCount() + 1 << " threads, best of " << ROUNDS << "\n";
+
+		for (uint32_t count : { 16u * 1024, 256u * 1024, 1024u * 1024, 4096u * 1024 }) {
+			createObjects(count);
+
+			measureSpheres();
+			measureBoxes();
+		}
+	}
+private:
+	static constexpr uint32_t ROUNDS = 10;
+
+	VEjobSystem jobs;
+	VEculler culler;
+	VEfrustum frustum{};
+
+	VEsphereBounds spheres;
+	VEboxBounds boxes;
+	std::vector<uint32_t> visible;
+
+	// box는 sphere를 감싸는 AABB
+	void createObjects(uint32_t count) {
+		std::mt19937 random(count);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> radius(0.5f, 2.0f);
+
+		spheres.clear();
+		boxes.clear();
+		for (uint32_t i = 0; i < count; i++) {
+			glm::vec3 center{ position(random), position(random), position(random) };
+			float r = radius(random);
+
+			spheres.add(center, r);
+			boxes.add(center - r, center + r);
+		}
+
+		visible.resize(count + 8);
+	}
+
+	// 가장 빠른 실행의 초
+	template <typename Func>
+	static double measure(Func func) {
+		double best = std::numeric_limits<double>::max();
+
+		for (uint32_t round = 0; round < ROUNDS; round++) {
+			auto start = std::chrono::high_resolution_clock::now();
+			func();
+			best = std::min(best, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+		}
+
+		return best;
+	}
+
+	void measureSpheres() {
+		auto count = spheres.size();
+		uint32_t scalarVisible{}, simdVisible{};
+
+		auto scalarSeconds = measure([&] {
+			scalarVisible = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				scalarVisible += frustum.testSphere(glm::vec3(spheres.x[i], spheres.y[i], spheres.z[i]), spheres.r[i]);
+			}
+		});
+		auto simdSeconds = measure([&] {
+			simdVisible = cullSpheres(frustum, spheres, 0, count, visible.data());
+		});
+		auto parallelSeconds = measure([&] {
+			culler.cull(&jobs, frustum, spheres);
+		});
+
+		print("spheres", count, scalarVisible, simdVisible, culler.getVisibleCount(), scalarSeconds, simdSeconds, parallelSeconds);
+	}
+
+	void measureBoxes() {
+		auto count = boxes.size();
+		uint32_t scalarVisible{}, simdVisible{};
+
+		auto scalarSeconds = measure([&] {
+			scalarVisible = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				scalarVisible += frustum.testBox(glm::vec3(boxes.x[i], boxes.y[i], boxes.z[i]),
+					glm::vec3(boxes.ex[i], boxes.ey[i], boxes.ez[i]));
+			}
+		});
+		auto simdSeconds = measure([&] {
+			simdVisible = cullBoxes(frustum, boxes, 0, count, visible.data());
+		});
+		auto parallelSeconds = measure([&] {
+			culler.cull(&jobs, frustum, boxes);
+		});
+
+		print("boxes", count, scalarVisible, simdVisible, culler.getVisibleCount(), scalarSeconds, simdSeconds, parallelSeconds);
+	}
+
+	static void print(const char* name, uint32_t count, uint32_t scalarVisible, uint32_t simdVisible, uint32_t parallelVisible,
+		double scalarSeconds, double simdSeconds, double parallelSeconds) {
+		auto rate = [&](double seconds) { return count / seconds / 1e6; };
+
+		std::cout << "\t" << name << " " << count << " : visible " << scalarVisible
+			<< ", scalar " << rate(scalarSeconds) << ", simd " << rate(simdSeconds) << ", parallel " << rate(parallelSeconds)
+			<< " M tests/s";
+		if (simdVisible != scalarVisible || parallelVisible != scalarVisible) {
+			std::cout << " (mismatch : simd " << simdVisible << ", parallel " << parallelVisible << ")";
+		}
+		std::cout << "\n";
+	}
+};
+
+int main(int argc, char** argv) {
+	auto app = new CullingBenchmark(parseSettings(argc, argv));
+	app->run();
+	delete app;
+
+	return EXIT_SUCCESS;
+}
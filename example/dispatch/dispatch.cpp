@@ -0,0 +1,157 @@
+#include "VEbase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// command buffer 기록 경로에서 Vulkan 함수 호출 한 번에 드는 CPU 시간을 비교한다 (ns / call)
+//	loader		: vulkan library가 export 하는 함수 (loader trampoline에서 dispatch table을 한 번 더 거친다)
+//	device		: vkGetDeviceProcAddr로 읽은 함수 pointer (driver 함수로 바로 간다)
+//	dispatcher	: vk::CommandBuffer 호출 (VULKAN_HPP_DEFAULT_DISPATCHER, VEbase가 device 함수로 채워둔다)
+// 같은 command buffer에 setViewport / setScissor / bindVertexBuffers를 반복 기록하고 submit 하지 않는다.
+// 기록 시간 외 (begin, end, pool reset)는 재지 않고, 여러 번 중 가장 빠른 값을 쓴다.
+//
+// validation layer가 켜져 있으면 모든 경로가 layer를 거치므로 Release build로 재야 한다.
+class DispatchBenchmark : public VEbase {
+public:
+	DispatchBenchmark(const VEsettings& settings) : VEbase("Vulkan Application - Dispatch", settings) {
+
+	}
+
+	~DispatchBenchmark() {
+		destroyBuffer(vertexBuffer, vertexAllocation);
+		device.destroyCommandPool(commandPool);
+
+		cleanUpBase();
+	}
+
+	void run() {
+		init();
+		prepare();
+
+		if (enableValidationLayers) {
+			std::cout << "dispatch : validation layer is enabled, measure with a Release build\n";
+		}
+
+		auto cb = static_cast<VkCommandBuffer>(commandBuffer);
+		auto buffer = static_cast<VkBuffer>(vertexBuffer);
+		auto pViewport = reinterpret_cast<const VkViewport*>(&viewport);
+		auto pScissor = reinterpret_cast<const VkRect2D*>(&scissor);
+		VkDeviceSize offset = 0;
+
+		auto loaderNs = measure([&] {
+			for (uint32_t i = 0; i < CALLS; i++) {
+				vkCmdSetViewport(cb, 0, 1, pViewport);
+				vkCmdSetScissor(cb, 0, 1, pScissor);
+				vkCmdBindVertexBuffers(cb, 0, 1, &buffer, &offset);
+			}
+		});
+
+		auto setViewport = reinterpret_cast<PFN_vkCmdSetViewport>(device.getProcAddr("vkCmdSetViewport"));
+		auto setScissor = reinterpret_cast<PFN_vkCmdSetScissor>(device.getProcAddr("vkCmdSetScissor"));
+		auto bindVertexBuffers = reinterpret_cast<PFN_vkCmdBindVertexBuffers>(device.getProcAddr("vkCmdBindVertexBuffers"));
+
+		auto deviceNs = measure([&] {
+			for (uint32_t i = 0; i < CALLS; i++) {
+				setViewport(cb, 0, 1, pViewport);
+				setScissor(cb, 0, 1, pScissor);
+				bindVertexBuffers(cb, 0, 1, &buffer, &offset);
+			}
+		});
+
+		auto dispatcherNs = measure([&] {
+			for (uint32_t i = 0; i < CALLS; i++) {
+				commandBuffer.setViewport(0, 1, &viewport);
+				commandBuffer.setScissor(0, 1, &scissor);
+				commandBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+			}
+		});
+
+		auto properties = physicalDevice.getProperties();
+		std::cout << "dispatch : " << properties.deviceName.data() << ", " << COMMANDS << " commands x " << CALLS
+			<< " calls, best of " << ROUNDS << "\n";
+		print("loader", loaderNs, loaderNs);
+		print("device", deviceNs, loaderNs);
+		print("dispatcher", dispatcherNs, loaderNs);
+	}
+private:
+	static constexpr uint32_t CALLS = 100000;
+	static constexpr uint32_t COMMANDS = 3;
+	static constexpr uint32_t ROUNDS = 10;
+
+	vk::CommandPool commandPool;
+	vk::CommandBuffer commandBuffer;
+
+	vk::Buffer vertexBuffer;
+	VEallocation vertexAllocation;
+
+	vk::Viewport viewport;
+	vk::Rect2D scissor;
+
+	void prepare() {
+		commandPool = device.createCommandPool(vk::CommandPoolCreateInfo{
+			.flags = vk::CommandPoolCreateFlagBits::eTransient,
+			.queueFamilyIndex = capabilities.queueFamilies.graphicsFamily.value(),
+		});
+
+		commandBuffer = device.allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+			.commandPool = commandPool,
+			.level = vk::CommandBufferLevel::ePrimary,
+			.commandBufferCount = 1,
+		}).front();
+
+		createBuffer(256, vk::BufferUsageFlagBits::eVertexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal,
+			vertexBuffer, vertexAllocation);
+
+		viewport = vk::Viewport{
+			.width = static_cast<float>(swapChainExtent.width),
+			.height = static_cast<float>(swapChainExtent.height),
+			.maxDepth = 1.0f,
+		};
+		scissor = vk::Rect2D{
+			.extent = swapChainExtent,
+		};
+	}
+
+	// 기록 한 번을 재서 call 당 시간 (ns)의 최소값을 돌려준다
+	template <typename Record>
+	double measure(Record record) {
+		double best = std::numeric_limits<double>::max();
+
+		for (uint32_t round = 0; round < ROUNDS; round++) {
+			device.resetCommandPool(commandPool);
+			commandBuffer.begin(vk::CommandBufferBeginInfo{
+				.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+			});
+
+			auto start = std::chrono::high_resolution_clock::now();
+			record();
+			auto ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+			commandBuffer.end();
+			best = std::min(best, ns / (CALLS * COMMANDS));
+		}
+
+		return best;
+	}
+
+	static void print(const char* name, double ns, double baselineNs) {
+		std::cout << "\t" << name << "\t: " << ns << " ns / call";
+		if (ns != baselineNs) {
+			std::cout << " (" << (baselineNs - ns) / baselineNs * 100.0 << "% faster than loader)";
+		}
+		std::cout << "\n";
+	}
+};
+
+int main(int argc, char** argv) {
+	// 화면 출력과 상관없는 측정이므로 항상 headless로 실행한다
+	auto settings = parseSettings(argc, argv);
+	settings.headless = true;
+
+	auto app = new DispatchBenchmark(settings);
+	app->run();
+	delete app;
+
+	return EXIT_SUCCESS;
+}
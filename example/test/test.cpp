@@ -2,7 +2,7 @@
 
 class TestApplication : public VEbase {
 public:
-	TestApplication() : VEbase("Vulkan Application - Test") {
+	TestApplication(const VEsettings& settings) : VEbase("Vulkan Application - Test", settings) {
 
 	}
 
@@ -13,8 +13,8 @@ public:
 	}
 };
 
-int main() {
-	auto temp = new TestApplication();
+int main(int argc, char** argv) {
+	auto temp = new TestApplication(parseSettings(argc, argv));
 	temp->run();
 
 	return EXIT_SUCCESS;
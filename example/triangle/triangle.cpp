@@ -2,30 +2,21 @@
 
 class Triangle : public VEbase {
 public:
-	Triangle() : VEbase("Vulkan Application - Triangle") {
+	Triangle(const VEsettings& settings) : VEbase("Vulkan Application - Triangle", settings) {
 
 	}
 
 	~Triangle() {
-		device.freeMemory(Indices.deviceMemory);
-		device.destroyBuffer(Indices.buffer);
+		destroyBuffer(Indices.buffer, Indices.allocation);
+		destroyBuffer(Vertices.buffer, Vertices.allocation);
 
-		device.freeMemory(Vertices.deviceMemory);
-		device.destroyBuffer(Vertices.buffer);
-
-		for (auto i = 0;i < MAX_FRAMES_IN_FLIGHT; i++) {
+		for (auto i = 0;i < framesInFlight; i++) {
 			device.destroySemaphore(imageAvailableSemaphores[i]);
-			device.destroySemaphore(renderFinishedSemaphores[i]);
 		}
 
-		destroyFences();
-
-		device.destroyCommandPool(commandPool);
-
 		destroyFrameBuffers();
 
 		device.destroyPipeline(graphicsPipeline);
-		device.destroyRenderPass(renderPass);
 		device.destroyPipelineLayout(pipelineLayout);
 
 		cleanUpBase();
@@ -45,7 +36,7 @@ private:
 
 	struct {
 		vk::Buffer buffer;
-		vk::DeviceMemory deviceMemory;
+		VEallocation allocation;
 
 		const std::vector<Vertex> vertices = {
 			{{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
@@ -83,15 +74,17 @@ private:
 
 	struct {
 		vk::Buffer buffer;
-		vk::DeviceMemory deviceMemory;
+		VEallocation allocation;
 
 		const std::vector<uint16_t> indices{
 			0, 1, 2
 		};
 	} Indices;
 
-	// Renderpass : 렌더링 구조를 명시한다고 보면 된다
-	vk::RenderPass renderPass;
+	// Render graph 상의 resource / pass 번호
+	// renderpass, framebuffer, layout transition은 graph가 만든다
+	uint32_t backbuffer;
+	uint32_t trianglePass;
 
 	// Pipeline이 Descriptor Sets에 접근하기 위해 필요하다
 	vk::PipelineLayout pipelineLayout;
@@ -99,12 +92,8 @@ private:
 	// Pipeline (pipeline state object) - 파이프라인 단계마다 렌더링 동작을 명시한다
 	vk::Pipeline graphicsPipeline;
 
-	// Framebuffer는 Renderpass에서 다루는 attachment의 메모리 저장 정보를 들고있다
-	std::vector<vk::Framebuffer> swapChainFrameBuffers;
-
 	// Queue 내의 synchronization에 사용한다
 	std::vector<vk::Semaphore> imageAvailableSemaphores;
-	std::vector<vk::Semaphore> renderFinishedSemaphores;
 
 	uint32_t currentFrame{ 0 };
 
@@ -112,119 +101,55 @@ private:
 		auto& vertices = Vertices.vertices;
 		auto size = sizeof(vertices[0]) * vertices.size();
 
-		vk::Buffer stagingBuffer;
-		vk::DeviceMemory stagingBufferMemory;
-		createBuffer(size,
-			vk::BufferUsageFlagBits::eTransferSrc,													// Transfer Src
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,	// Host Visible | Host Coherent
-			stagingBuffer, stagingBufferMemory);
-
-		// Staging Buffer에 데이터 복사
-		auto data = device.mapMemory(stagingBufferMemory, 0, size);
-		memcpy(data, Vertices.vertices.data(), (size_t)size);
-		device.unmapMemory(stagingBufferMemory);
-
 		// Device Local 영역에 두는 것이 목적. GPU가 read하는데 가장 optimal한 영역임.
 		createBuffer(size,
 			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,		// Transfer Dst | Vertex Buffer
 			vk::MemoryPropertyFlagBits::eDeviceLocal,											// Device Local
-			Vertices.buffer, Vertices.deviceMemory);
-
-		copyBuffer(stagingBuffer, Vertices.buffer, size);
+			Vertices.buffer, Vertices.allocation);
 
-		device.destroyBuffer(stagingBuffer);
-		device.freeMemory(stagingBufferMemory);
+		// Staging ring에 데이터 복사 후 copy 명령만 기록해둔다. 실제 submit은 flush 시점에 한번에
+		staging.upload(Vertices.buffer, 0, vertices.data(), size);
 	}
 
 	void createIndexBuffer() {
 		auto& indices = Indices.indices;
 		auto size = sizeof(indices[0]) * indices.size();
 
-		vk::Buffer stagingBuffer;
-		vk::DeviceMemory stagingBufferMemory;
-		createBuffer(size,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			stagingBuffer, stagingBufferMemory);
-
-		auto data = device.mapMemory(stagingBufferMemory, 0, size);
-		memcpy(data, indices.data(), size);
-		device.unmapMemory(stagingBufferMemory);
-
 		createBuffer(size,
 			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
 			vk::MemoryPropertyFlagBits::eDeviceLocal,
-			Indices.buffer, Indices.deviceMemory);
-
-		copyBuffer(stagingBuffer, Indices.buffer, size);
+			Indices.buffer, Indices.allocation);
 
-		device.destroyBuffer(stagingBuffer);
-		device.freeMemory(stagingBufferMemory);
+		staging.upload(Indices.buffer, 0, indices.data(), size);
 	}
 
 	void prepare() {
-		createRenderPass();
+		buildRenderGraph();
 		createGraphicsPipeLine();
 		createFrameBuffers();
-		createCommandPool();
-		createCommandBuffers();
 		createSyncObjects();
 		createVertexBuffer();
 		createIndexBuffer();
-	}
-
-	// - Attachment
-	//		렌더링 과정에서 사용하는 이미지
-	// - Subpass
-	//		1개 이상의 subpass를 가진다
-	// - Subpass Dependency
-	//		srcSubpass - 의존 관계에 있는 subpass / dstSubpass - 현재 subpass
-	//		StageMask <- Pipeline Stage 명시
-	//			src - ensures logically earlier stages to be executed
-	//			dst - ensures logically later stages not to be executed
-	//		AccessMask <- Memory access
-	void createRenderPass() {
-		vk::AttachmentDescription colorAttachment{
-			.format = swapChainFormat,
-			.samples = vk::SampleCountFlagBits::e1,
-			.loadOp = vk::AttachmentLoadOp::eClear,
-			.storeOp = vk::AttachmentStoreOp::eStore,
-			.stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
-			.stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-			.initialLayout = vk::ImageLayout::eUndefined,
-			.finalLayout = vk::ImageLayout::ePresentSrcKHR,
-		};
 
-		vk::AttachmentReference colorAttachmentRef{
-			.attachment = 0,
-			.layout = vk::ImageLayout::eColorAttachmentOptimal,
-		};
+		// 첫 frame이 upload 완료를 GPU에서 기다리도록 한다
+		staging.waitOnGraphics(staging.flush());
+	}
 
-		vk::SubpassDescription subpass{
-			.pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
-			.colorAttachmentCount = 1,
-			.pColorAttachments = &colorAttachmentRef,
-		};
+	// pass가 어떤 image를 쓰는지만 선언하면
+	// attachment load / store op, layout transition, barrier는 graph가 결정한다
+	void buildRenderGraph() {
+		backbuffer = renderGraph.importBackbuffer("backbuffer", swapChainFormat, getPresentLayout());
 
-		vk::SubpassDependency dependency{
-			.srcSubpass = VK_SUBPASS_EXTERNAL,
-			.dstSubpass = 0,
-			.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
-			.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
-			.srcAccessMask = vk::AccessFlagBits::eNone,
-			.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
-		};
+		// attachment loadOp = Clear 시 값 지정
+		vk::ClearValue clearValue;
+		clearValue.color = { 0.0f, 0.0f, 0.1f, 1.0f };
 
-		vk::RenderPassCreateInfo renderPassInfo{
-			.attachmentCount = 1,
-			.pAttachments = &colorAttachment,
-			.subpassCount = 1,
-			.pSubpasses = &subpass,
-			.dependencyCount = 1,
-			.pDependencies = &dependency,
-		};
+		trianglePass = renderGraph.addPass("triangle", [this](vk::CommandBuffer commandBuffer) {
+			drawTriangle(commandBuffer);
+		});
+		renderGraph.writeColor(trianglePass, backbuffer, clearValue);
 
-		renderPass = device.createRenderPass(renderPassInfo);
+		renderGraph.compile();
 	}
 
 	void createGraphicsPipeLine() {
@@ -330,91 +255,39 @@ private:
 			.pColorBlendState = &colorBlendState,
 			.pDynamicState = &dynamicState,
 			.layout = pipelineLayout,
-			.renderPass = renderPass,
+			.renderPass = renderGraph.getRenderPass(trianglePass),
 			.subpass = 0,	//index
 		};
 
-		graphicsPipeline = device.createGraphicsPipeline(nullptr, pipelineInfo).value;
+		graphicsPipeline = pipelineCache.createGraphicsPipeline(pipelineInfo);
 
 		device.destroyShaderModule(vertModule);
 		device.destroyShaderModule(fragModule);
 	}
 
-	// Renderpass에서 명시한 attachment description과 구조가 일치하여야 함
+	// swapchain image가 바뀔 때마다 graph의 framebuffer를 다시 만든다
 	virtual void createFrameBuffers() {
-		swapChainFrameBuffers.resize(swapChainImageViews.size());
-
-		for (auto i = 0; i < swapChainFrameBuffers.size(); i++) {
-			vk::ImageView attachments[] {
-				swapChainImageViews[i],
-			};
-
-			vk::FramebufferCreateInfo framebufferInfo{
-				.renderPass = renderPass,
-				.attachmentCount = 1,
-				.pAttachments = attachments,
-				.width = swapChainExtent.width,
-				.height = swapChainExtent.height,
-				.layers = 1,
-			};
-
-			swapChainFrameBuffers[i] = device.createFramebuffer(framebufferInfo);
-		}
+		renderGraph.setBackbuffer(swapChainImages, swapChainImageViews, swapChainExtent);
 	}
 
 	virtual void destroyFrameBuffers() {
-		for (auto i = 0; i < swapChainFrameBuffers.size(); i++) {
-			device.destroyFramebuffer(swapChainFrameBuffers[i]);
-		}
-	}
-
-	void createCommandPool() {
-		auto queueFamilyIndices = findQueueFamilies(physicalDevice, surface);
-
-		vk::CommandPoolCreateInfo poolInfo{
-			.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-			.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value(),
-		};
-
-		commandPool = device.createCommandPool(poolInfo);
-	}
-
-	void createCommandBuffers() {
-		commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			vk::CommandBufferAllocateInfo allocInfo{
-				.commandPool = commandPool,
-				.level = vk::CommandBufferLevel::ePrimary,
-				.commandBufferCount = 1,
-			};
-
-			commandBuffers[i] = device.allocateCommandBuffers(allocInfo).front();
-		}
+		renderGraph.releaseTargets();
 	}
 
 	void recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex) {
 		vk::CommandBufferBeginInfo beginInfo{};
 		commandBuffer.begin(beginInfo);
 
-		// attachment loadOp = Clear 시 값 지정
-		vk::ClearValue clearValue;
-		clearValue.color = { 0.0f, 0.0f, 0.1f, 1.0f };
-		clearValue.depthStencil = {0.1f, 0};
-
-		vk::RenderPassBeginInfo renderPassInfo{
-			.renderPass = renderPass,
-			.framebuffer = swapChainFrameBuffers[imageIndex],
-			.renderArea = {
-				.offset = {0, 0},
-				.extent = swapChainExtent,
-			},
-			.clearValueCount = 1,
-			.pClearValues = &clearValue,
-		};
+		// 이 slot의 이전 frame GPU 시간을 읽고 새 query를 기록한다
+		gpuProfiler.beginFrame(commandBuffer, currentFrame);
 
-		commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+		renderGraph.execute(commandBuffer, imageIndex);
 
+		commandBuffer.end();
+	}
+
+	// triangle pass - renderpass 안에서 호출된다
+	void drawTriangle(vk::CommandBuffer commandBuffer) {
 		// Update dynamic state
 		commandBuffer.setViewport(0, vk::Viewport{
 			.x = 0,
@@ -440,83 +313,61 @@ private:
 		commandBuffer.bindIndexBuffer(Indices.buffer, 0, vk::IndexType::eUint16);
 
 		commandBuffer.drawIndexed(static_cast<uint32_t>(Vertices.vertices.size()), 1, 0, 0, 0);
-		
-		commandBuffer.endRenderPass();
-
-		commandBuffer.end();
 	}
 
 	void createSyncObjects() {
 		vk::SemaphoreCreateInfo semaforeInfo{};
 
-		imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+		// present 용 semaphore는 base가 swapchain image 마다 만든다 (presentReadySemaphores)
+		imageAvailableSemaphores.resize(framesInFlight);
 
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		for (auto i = 0; i < framesInFlight; i++) {
 			imageAvailableSemaphores[i] = device.createSemaphore(semaforeInfo);
-			renderFinishedSemaphores[i] = device.createSemaphore(semaforeInfo);
 		}
 	}
 
 	virtual void drawFrame() {
-		std::ignore = device.waitForFences({ inflightFences[currentFrame]}, vk::False, UINT64_MAX);
+		// framesInFlight 전 frame이 GPU에서 끝날 때까지 기다린다 (frame timeline)
+		currentFrame = beginFrame();
 
 		if (framebufferResized) {
 			recreateSwapChain();
 			framebufferResized = false;
 		}
 
-		auto result{ device.acquireNextImageKHR(swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame], nullptr) };
-		if (result.result == vk::Result::eSuboptimalKHR || result.result == vk::Result::eErrorOutOfDateKHR) {
-			framebufferResized = true;
+		uint32_t imageIndex{};
+		auto result{ acquireNextImage(imageAvailableSemaphores[currentFrame], imageIndex) };
+		// out of date : image를 받지 못했고 semaphore도 signal 되지 않으므로 submit 하지 않는다
+		// (frame 번호를 소비하지 않았으므로 다음 drawFrame이 같은 번호로 다시 시작한다)
+		if (result == vk::Result::eErrorOutOfDateKHR) {
+			recreateSwapChain();
+			framebufferResized = false;
 			return;
 		}
-		
-		device.resetFences({ inflightFences[currentFrame]});
-
-		uint32_t imageIndex{ result.value };
+		// suboptimal : image는 받았고 semaphore가 signal 되므로 이번 frame은 그리고 다음 frame에 재생성한다
+		if (result == vk::Result::eSuboptimalKHR) {
+			framebufferResized = true;
+		}
 
-		commandBuffers[currentFrame].reset();
-		recordCommandBuffer(commandBuffers[currentFrame], imageIndex);
+		// 이 slot의 command pool을 통째로 reset 하고 primary command buffer를 받는다
+		auto commandBuffer = commandRecorder.beginFrame(currentFrame);
+		recordCommandBuffer(commandBuffer, imageIndex);
 		
-		vk::Semaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame] };
-		vk::Semaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
-		vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
-
-		vk::SubmitInfo submitInfo{
-			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = waitSemaphores,
-			.pWaitDstStageMask = waitStages,
-			.commandBufferCount = 1,
-			.pCommandBuffers = &commandBuffers[currentFrame],
-			.signalSemaphoreCount = 1,
-			.pSignalSemaphores = signalSemaphores,
-		};
-
-		graphicsQueue.submit(submitInfo, inflightFences[currentFrame]);
+		// 이번 frame 중 요청된 upload가 있다면 frame보다 먼저 submit 된다
+		submitFrame(commandBuffer, imageAvailableSemaphores[currentFrame], presentReadySemaphores[imageIndex]);
 
-		vk::SwapchainKHR swapChains[]{ swapChain };
-		vk::PresentInfoKHR presentInfo{
-			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = signalSemaphores,
-			.swapchainCount = 1,
-			.pSwapchains = swapChains,
-			.pImageIndices = &imageIndex,
-		};
-
-		auto presentResult = vkQueuePresentKHR((VkQueue&)presentQueue, &(VkPresentInfoKHR&)presentInfo);
-		if (presentResult == VkResult::VK_ERROR_OUT_OF_DATE_KHR) {
+		auto presentResult = presentImage(presentReadySemaphores[imageIndex], imageIndex);
+		if (presentResult == vk::Result::eErrorOutOfDateKHR) {
 			framebufferResized = true;
 			return;
 		}
-
-		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 	}
 };
 
-int main() {
-	auto app = new Triangle();
+int main(int argc, char** argv) {
+	auto app = new Triangle(parseSettings(argc, argv));
 	app->run();
+	delete app;
 
 	return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -2,27 +2,35 @@
 
 class Uniform : public VEbase {
 public:
-	Uniform() : VEbase("Vulkan Application - Uniform buffer") {
+	Uniform(const VEsettings& settings) : VEbase("Vulkan Application - Uniform buffer", settings) {
 
 	}
 
 	~Uniform() {
-		// (TODO) vertices, indices, uniform datas
-		device.destroyBuffer();
-		device.freeMemory();
+		// buffer와 descriptor pool 등은 deletion queue를 거쳐 cleanUpBase에서 파괴된다
+		retireBuffer(Vertices.buffer, Vertices.allocation);
+		retireBuffer(Indices.buffer, Indices.allocation);
+		for (auto& uniform : uniformData) {
+			if (bindlessEnabled) {
+				retire([this, index = uniform.bindlessIndex]() { bindless.removeBuffer(index); });
+			}
+			retireBuffer(uniform.buffer, uniform.allocation);
+		}
 
+		// descriptor set은 base의 descriptorAllocator pool과 함께 해제된다
+		retire(pipelineLayout);
+		descriptorTemplate.cleanUp();
 		device.destroyDescriptorSetLayout(descriptorSetLayout);
 
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		for (auto i = 0; i < framesInFlight; i++) {
 			device.destroySemaphore(renderSemaphores[i]);
-			device.destroySemaphore(presentReadySemaphores[i]);
 		}
-		destroyFences();
 
-		device.destroyCommandPool(commandPool);
 		destroyFrameBuffers();
 		device.destroyPipeline(graphicsPipeline);
 		device.destroyRenderPass(renderpass);
+
+		cleanUpBase();
 	}
 
 	void run() {
@@ -36,8 +44,9 @@ private:
 	vk::Pipeline graphicsPipeline;
 
 	vk::DescriptorSetLayout descriptorSetLayout{};
-	std::vector<vk::DescriptorSet> descriptorSets{};
-	vk::DescriptorPool descriptorPool{};
+	vk::DescriptorSet descriptorSet{};	// base의 uniformRing 전체 (frame 마다 dynamic offset만 바뀐다)
+	uint32_t uniformOffset{ 0 };
+	VEdescriptorTemplate descriptorTemplate;
 
 	std::vector<vk::Framebuffer> frameBuffers;
 
@@ -50,7 +59,7 @@ private:
 
 	struct {
 		vk::Buffer buffer;
-		vk::DeviceMemory memory;
+		VEallocation allocation;
 
 		const std::vector<Vertex> vertices = {
 			{{-0.5, -0.5f}, {1.0f, 0.0f, 0.0f}},
@@ -83,7 +92,7 @@ private:
 
 	struct {
 		vk::Buffer buffer;
-		vk::DeviceMemory memory;
+		VEallocation allocation;
 
 		const std::vector<uint16_t> indices = {
 			0, 2, 1, 1, 2, 3
@@ -98,47 +107,83 @@ private:
 
 	struct UniformData {
 		vk::Buffer buffer;
-		vk::DeviceMemory memory;
+		VEallocation allocation;
 		UniformBufferObject data;
 		void* map;
+		uint32_t bindlessIndex{ VEhandleAllocator::INVALID };	// bindless set의 storage buffer slot
 	};
 
-	std::array<UniformData, 2> uniformData{};
+	std::vector<UniformData> uniformData;	// bindless mode 전용 (그 외에는 base의 uniformRing)
+	VEtripleBuffer<UniformBufferObject> frameState;	// simulate (main thread) -> drawFrame (render thread)
 
+	// bindless mode : bindless set에 등록할 frame 별 storage buffer
 	void createUniformBuffer() {
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		if (!bindlessEnabled) return;
+
+		uniformData.resize(framesInFlight);
+
+		for (auto i = 0; i < framesInFlight; i++) {
 			auto size = sizeof(UniformBufferObject);
 			createBuffer(size,
-				vk::BufferUsageFlagBits::eUniformBuffer,
+				vk::BufferUsageFlagBits::eStorageBuffer,
 				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-				uniformData[i].buffer, uniformData[i].memory);
+				uniformData[i].buffer, uniformData[i].allocation);
 
-			uniformData[i].map = device.mapMemory(uniformData[i].memory, 0, size);
+			uniformData[i].map = uniformData[i].allocation.mapped;
 		}
 	}
 
-	void updateUniformBuffer(uint32_t currentImage) {
+	// main thread : 다음 frame의 상태를 계산해서 render thread에 넘긴다
+	void simulate() override {
+		VE_PROFILE_FUNCTION();
+
 		static auto startTime = std::chrono::high_resolution_clock::now();
 
 		auto currentTime = std::chrono::high_resolution_clock::now();
 		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
-		UniformBufferObject ubo{
+		// swapChainExtent는 render thread가 바꾸므로 main thread가 갱신한 크기를 쓴다
+		float aspect = framebufferHeight > 0 ? framebufferWidth / (float)framebufferHeight : 1.0f;
+
+		auto& ubo = frameState.back();
+		ubo = UniformBufferObject{
 			.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
 			.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
-			.proj = glm::perspective(glm::radians(45.0f), swapChainExtent.width / (float)swapChainExtent.height, 0.1f, 10.0f),
+			.proj = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 10.0f),
 		};
 
 		// GLM's Y coord. of the clip coord. is inverted
 		ubo.proj[1][1] *= -1;
 
-		memcpy(uniformData[currentImage].map, &ubo, sizeof(ubo));
+		frameState.publish();
+	}
+
+	// render thread : 가장 최근에 simulate 된 상태를 쓴다 (새 상태가 없으면 이전 상태 그대로)
+	void updateUniformBuffer(uint32_t currentImage) {
+		VE_PROFILE_FUNCTION();
+
+		frameState.acquire();
+		if (bindlessEnabled) {
+			memcpy(uniformData[currentImage].map, &frameState.front(), sizeof(UniformBufferObject));
+		}
+		else {
+			// slot은 beginFrame에서 비워지므로 frame 마다 새로 잘라 쓴다
+			uniformOffset = uniformRing.push(frameState.front());
+		}
 	}
 
 	void setDescriptorSets() {
+		// bindless : frame 별 buffer를 bindless set에 등록하고 draw 마다 index만 넘긴다
+		if (bindlessEnabled) {
+			for (auto& uniform : uniformData) {
+				uniform.bindlessIndex = bindless.addBuffer(uniform.buffer, 0, sizeof(UniformBufferObject));
+			}
+			return;
+		}
+
 		vk::DescriptorSetLayoutBinding uboLayoutBinding{
 			.binding = 0,
-			.descriptorType = vk::DescriptorType::eUniformBuffer,
+			.descriptorType = vk::DescriptorType::eUniformBufferDynamic,
 			.descriptorCount = 1,
 			.stageFlags = vk::ShaderStageFlagBits::eVertex,
 		};
@@ -150,46 +195,15 @@ private:
 
 		descriptorSetLayout = device.createDescriptorSetLayout(descriptorSetLayoutCI);
 
-		vk::DescriptorPoolSize poolSize{
-			.type = vk::DescriptorType::eUniformBuffer,
-			.descriptorCount = MAX_FRAMES_IN_FLIGHT,	// descriptor 타입 별 개수 상한
-		};
-
-		vk::DescriptorPoolCreateInfo descriptorPoolCI{
-			.maxSets = MAX_FRAMES_IN_FLIGHT,	// 풀에 존재할 수 있는 set의 개수 상한
-			.poolSizeCount = 1,
-			.pPoolSizes = &poolSize,
-		};
-
-		descriptorPool = device.createDescriptorPool(descriptorPoolCI);
-
-		std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
-		vk::DescriptorSetAllocateInfo allocInfo{
-			.descriptorPool = descriptorPool,
-			.descriptorSetCount = MAX_FRAMES_IN_FLIGHT,
-			.pSetLayouts = layouts.data(),
-		};
-
-		descriptorSets = device.allocateDescriptorSets(allocInfo);
-
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			vk::DescriptorBufferInfo bufferInfo{
-				.buffer = uniformData[i].buffer,
-				.offset = 0,
-				.range = sizeof(UniformBufferObject),
-			};
-
-			vk::WriteDescriptorSet descriptorWrite{
-				.dstSet = descriptorSets[i],
-				.dstBinding = 0,
-				.dstArrayElement = 0,
-				.descriptorCount = 1,
-				.descriptorType = vk::DescriptorType::eUniformBuffer,
-				.pBufferInfo = &bufferInfo,
-			};
+		// binding 0의 data는 vk::DescriptorBufferInfo 하나
+		descriptorTemplate.init(device, descriptorSetLayout, {
+			{ .binding = 0, .type = vk::DescriptorType::eUniformBufferDynamic },
+		});
 
-			device.updateDescriptorSets(descriptorWrite, nullptr);
-		}
+		// pool은 base의 descriptorAllocator가 필요한 만큼 늘린다
+		// 모든 frame slot이 uniformRing의 한 buffer 안에 있으므로 set 하나로 충분하다
+		descriptorSet = descriptorAllocator.allocate(descriptorSetLayout);
+		descriptorTemplate.update(descriptorSet, uniformRing.getDescriptorInfo(sizeof(UniformBufferObject)));
 	}
 
 	void prepare() {
@@ -206,7 +220,7 @@ private:
 			.stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
 			.stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
 			.initialLayout = vk::ImageLayout::eUndefined,
-			.finalLayout = vk::ImageLayout::ePresentSrcKHR,
+			.finalLayout = getPresentLayout(),
 		};
 
 		vk::AttachmentReference attachmentRef{
@@ -241,7 +255,7 @@ private:
 		renderpass = device.createRenderPass(renderPassCI);
 
 		// pipeline
-		auto vert = readFileAsBinary(getShadersPath() + "uniform/uniform.vert.spv");
+		auto vert = readFileAsBinary(getShadersPath() + (bindlessEnabled ? "bindless/bindless.vert.spv" : "uniform/uniform.vert.spv"));
 		auto frag = readFileAsBinary(getShadersPath() + "uniform/uniform.frag.spv");
 		
 		auto vertShaderModule = createShaderModule(vert);
@@ -312,9 +326,18 @@ private:
 			.pAttachments = &colorblendAttachmentState,
 		};
 
+		vk::PushConstantRange drawRange{
+			.stageFlags = vk::ShaderStageFlagBits::eVertex,
+			.offset = 0,
+			.size = sizeof(uint32_t),
+		};
+
+		auto setLayout = bindlessEnabled ? bindless.getLayout() : descriptorSetLayout;
 		vk::PipelineLayoutCreateInfo layoutCI{
 			.setLayoutCount = 1,
-			.pSetLayouts = &descriptorSetLayout,
+			.pSetLayouts = &setLayout,
+			.pushConstantRangeCount = bindlessEnabled ? 1u : 0u,
+			.pPushConstantRanges = &drawRange,
 		};
 
 		pipelineLayout = device.createPipelineLayout(layoutCI);
@@ -335,7 +358,7 @@ private:
 			.subpass = 0,
 		};
 
-		graphicsPipeline = device.createGraphicsPipeline(nullptr, pipelineCI).value;
+		graphicsPipeline = pipelineCache.createGraphicsPipeline(pipelineCI);
 
 		device.destroyShaderModule(vertShaderModule);
 		device.destroyShaderModule(fragShaderModule);
@@ -343,74 +366,26 @@ private:
 		// framebuffer
 		createFrameBuffers();
 
-		// commmandpool
-		vk::CommandPoolCreateInfo commandPoolCI{
-			.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-			.queueFamilyIndex = findQueueFamilies(physicalDevice, surface).graphicsFamily.value(),
-		};
+		// sync object (frame 완료는 base의 frame timeline으로 추적한다)
+		// present 용 semaphore는 base가 swapchain image 마다 만든다 (presentReadySemaphores)
+		renderSemaphores.resize(framesInFlight);
 
-		commandPool = device.createCommandPool(commandPoolCI);
-
-		// commandbuffer
-		commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-
-		for (auto i = 0; i < commandBuffers.size(); i++) {
-			vk::CommandBufferAllocateInfo allocInfo{
-				.commandPool = commandPool,
-				.level = vk::CommandBufferLevel::ePrimary,
-				.commandBufferCount = 1,
-			};
-
-			commandBuffers[i] = device.allocateCommandBuffers(allocInfo).front();
-		}
-
-		// sync object
-		vk::FenceCreateInfo fenceCI{
-			.flags = vk::FenceCreateFlagBits::eSignaled,
-		};
-
-		inflightFences.resize(MAX_FRAMES_IN_FLIGHT);
-		renderSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		presentReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			inflightFences[i] = device.createFence(fenceCI);
+		for (auto i = 0; i < framesInFlight; i++) {
 			renderSemaphores[i] = device.createSemaphore({});
-			presentReadySemaphores[i] = device.createSemaphore({});
 		}
 
-		vk::Buffer stagingBuffer;
-		vk::DeviceMemory stagingBufferMemory;
-		
 		// vertexbuffer
 		auto size = sizeof(Vertices.vertices[0]) * Vertices.vertices.size();
-		createBuffer(size, vk::BufferUsageFlagBits::eTransferSrc, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer, stagingBufferMemory);
-
-		auto data = device.mapMemory(stagingBufferMemory, 0, size);
-		memcpy(data, Vertices.vertices.data(), size);
-		device.unmapMemory(stagingBufferMemory);
-
-		createBuffer(size, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, Vertices.buffer, Vertices.memory);
-
-		copyBuffer(stagingBuffer, Vertices.buffer, size);
-
-		device.destroyBuffer(stagingBuffer);
-		device.freeMemory(stagingBufferMemory);
+		createBuffer(size, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, Vertices.buffer, Vertices.allocation);
+		staging.upload(Vertices.buffer, 0, Vertices.vertices.data(), size);
 
 		// indexbuffer
 		size = sizeof(Indices.indices[0]) * Indices.indices.size();
-		createBuffer(size, vk::BufferUsageFlagBits::eTransferSrc, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer, stagingBufferMemory);
-
-		data = device.mapMemory(stagingBufferMemory, 0, size);
-		memcpy(data, Indices.indices.data(), size);
-		device.unmapMemory(stagingBufferMemory);
-
-		createBuffer(size, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, Indices.buffer, Indices.memory);
+		createBuffer(size, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, Indices.buffer, Indices.allocation);
+		staging.upload(Indices.buffer, 0, Indices.indices.data(), size);
 
-		copyBuffer(stagingBuffer, Indices.buffer, size);
-
-		device.destroyBuffer(stagingBuffer);
-		device.freeMemory(stagingBufferMemory);
+		// vertex, index upload를 한번의 submit으로, 첫 frame은 GPU에서 완료를 기다린다
+		staging.waitOnGraphics(staging.flush());
 	}
 
 	void createFrameBuffers() {
@@ -434,16 +409,21 @@ private:
 		}
 	}
 
+	// 재생성 중에도 이전 framebuffer를 사용하는 frame이 남아있을 수 있다
 	void destroyFrameBuffers() {
-		for (auto i = 0; i < frameBuffers.size(); i++) {
-			device.destroyFramebuffer(frameBuffers[i]);
+		for (auto frameBuffer : frameBuffers) {
+			retire(frameBuffer);
 		}
+		frameBuffers.clear();
 	}
 
 	void recordCommand(vk::CommandBuffer commandbuffer, uint32_t imageIndex) {
 		vk::CommandBufferBeginInfo beginInfo{};
 		commandbuffer.begin(beginInfo);
 
+		gpuProfiler.beginFrame(commandbuffer, currentFrame);
+		auto zone = gpuProfiler.beginZone(commandbuffer, "uniform");
+
 		vk::ClearValue clearValue{ {0.0f, 0.0f, 0.0f, 1.0f} };
 		vk::RenderPassBeginInfo renderPassInfo{
 			.renderPass = renderpass,
@@ -480,70 +460,67 @@ private:
 		commandbuffer.bindIndexBuffer(Indices.buffer, 0, vk::IndexType::eUint16);
 
 		// bind descriptor sets
-		commandbuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, 1, &descriptorSets[currentFrame], 0, nullptr);
+		if (bindlessEnabled) {
+			// set은 frame에 한 번, draw 마다는 push constant로 index만 바꾼다
+			bindless.bind(commandbuffer, vk::PipelineBindPoint::eGraphics, pipelineLayout);
+
+			uint32_t transformIndex = uniformData[currentFrame].bindlessIndex;
+			commandbuffer.pushConstants(pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(transformIndex), &transformIndex);
+		}
+		else {
+			commandbuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, 1, &descriptorSet, 1, &uniformOffset);
+		}
 
 		// draw();
 		commandbuffer.drawIndexed(Indices.indices.size(), 1, 0, 0, 0);
 
 		commandbuffer.endRenderPass();
+
+		gpuProfiler.endZone(commandbuffer, zone);
 		commandbuffer.end();
 	}
 
 	void drawFrame() {
-		std::ignore = device.waitForFences(inflightFences[currentFrame], vk::False, UINT64_MAX);
+		currentFrame = beginFrame();
 
 		if (framebufferResized) {
 			recreateSwapChain();
 			framebufferResized = false;
 		}
 
-		auto result{ device.acquireNextImageKHR(swapChain, UINT64_MAX, renderSemaphores[currentFrame], nullptr) };
-		if (result.result == vk::Result::eSuboptimalKHR) {
+		uint32_t imageIndex{};
+		auto result{ acquireNextImage(renderSemaphores[currentFrame], imageIndex) };
+		// out of date : image를 받지 못했고 semaphore도 signal 되지 않으므로 submit 하지 않는다
+		// (frame 번호를 소비하지 않았으므로 다음 drawFrame이 같은 번호로 다시 시작한다)
+		if (result == vk::Result::eErrorOutOfDateKHR) {
+			recreateSwapChain();
+			framebufferResized = false;
+			return;
+		}
+		if (result == vk::Result::eSuboptimalKHR) {
 			framebufferResized = true;
 		}
 
-		device.resetFences(inflightFences[currentFrame]);
+		// command buffer는 base의 commandRecorder가 frame slot 별 pool에서 준다
+		auto commandBuffer = commandRecorder.beginFrame(currentFrame);
 
-		commandBuffers[currentFrame].reset();
-		
-		uint32_t imageIndex{result.value};
 		updateUniformBuffer(currentFrame);
 
-		recordCommand(commandBuffers[currentFrame], imageIndex);
-
-		vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
-		vk::SubmitInfo submitInfo{
-			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = &renderSemaphores[currentFrame],
-			.pWaitDstStageMask = waitStages,
-			.commandBufferCount = 1,
-			.pCommandBuffers = &commandBuffers[currentFrame],
-			.signalSemaphoreCount = 1,
-			.pSignalSemaphores = &presentReadySemaphores[currentFrame],
-		};
+		recordCommand(commandBuffer, imageIndex);
 
-		graphicsQueue.submit(submitInfo, inflightFences[currentFrame]);
+		submitFrame(commandBuffer, renderSemaphores[currentFrame], presentReadySemaphores[imageIndex]);
 
-		vk::PresentInfoKHR presentInfo{
-			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = &presentReadySemaphores[currentFrame],
-			.swapchainCount = 1,
-			.pSwapchains = &swapChain,
-			.pImageIndices = &imageIndex,
-		};
-
-		auto presentResult = vkQueuePresentKHR((VkQueue&)presentQueue, &(VkPresentInfoKHR&)presentInfo);
-		if (presentResult == VkResult::VK_ERROR_OUT_OF_DATE_KHR) {
+		auto presentResult = presentImage(presentReadySemaphores[imageIndex], imageIndex);
+		if (presentResult == vk::Result::eErrorOutOfDateKHR) {
 			recreateSwapChain();
 		}
-
-		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 	}
 };
 
-int main() {
-	auto app = new Uniform();
+int main(int argc, char** argv) {
+	auto app = new Uniform(parseSettings(argc, argv));
 	app->run();
+	delete app;
 
 	return 0;
 }
\ No newline at end of file
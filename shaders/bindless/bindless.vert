@@ -0,0 +1,28 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// bindless set : binding 0 = storage buffer 배열 (VEbindless::eStorageBuffers)
+layout(set = 0, binding = 0) readonly buffer Transform {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} transforms[];
+
+// draw 마다 읽을 배열 index
+layout(push_constant) uniform Draw {
+    uint transformIndex;
+} draw;
+
+layout(location = 0) in vec2 pos;
+layout(location = 1) in vec3 color;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    mat4 model = transforms[draw.transformIndex].model;
+    mat4 view = transforms[draw.transformIndex].view;
+    mat4 proj = transforms[draw.transformIndex].proj;
+
+    gl_Position = proj * view * model * vec4(pos, 0.0, 1.0);
+    fragColor = color;
+}
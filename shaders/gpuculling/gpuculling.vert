@@ -0,0 +1,34 @@
+#version 450
+
+// VEgpuCuller의 object buffer (gl_InstanceIndex = object 번호)
+struct Object {
+    vec4 sphere;
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint padding;
+};
+
+layout(set = 0, binding = 0) readonly buffer Objects {
+    Object objects[];
+};
+
+// benchmark의 getObjectModel을 GPU에서 한다 : quad는 자기 중심으로 돈다
+layout(push_constant) uniform Draw {
+    mat4 viewProjModel;     // proj * view * scene model
+    float angle;
+} draw;
+
+layout(location = 0) in vec2 pos;
+layout(location = 1) in vec3 color;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    vec2 center = objects[gl_InstanceIndex].sphere.xy;
+    float spin = draw.angle * 4.0 + float(gl_InstanceIndex) * 0.01;
+    mat2 rotation = mat2(cos(spin), sin(spin), -sin(spin), cos(spin));
+
+    gl_Position = draw.viewProjModel * vec4(center + rotation * (pos - center), 0.0, 1.0);
+    fragColor = color;
+}
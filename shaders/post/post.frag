@@ -0,0 +1,18 @@
+#version 450
+
+// render graph의 이전 pass 결과를 읽어 가장자리를 어둡게 한다 (vignette 0 -> 그대로 복사)
+layout(set = 0, binding = 0) uniform sampler2D source;
+
+layout(push_constant) uniform Post {
+    float vignette;
+} post;
+
+layout(location = 0) in vec2 uv;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec2 d = uv - 0.5;
+    vec3 color = texture(source, uv).rgb * (1.0 - post.vignette * dot(d, d) * 2.0);
+    outColor = vec4(color, 1.0);
+}
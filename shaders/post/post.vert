@@ -0,0 +1,9 @@
+#version 450
+
+// vertex buffer 없이 화면 전체를 덮는 삼각형 하나 (draw(3))
+layout(location = 0) out vec2 uv;
+
+void main() {
+    uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 450
+
+// CPU에서 미리 곱한 proj * view * model (VEdrawMvp, normal을 쓰지 않으므로 mvp만)
+layout(push_constant) uniform Draw {
+    mat4 mvp;
+} draw;
+
+layout(location = 0) in vec2 pos;
+layout(location = 1) in vec3 color;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    gl_Position = draw.mvp * vec4(pos, 0.0, 1.0);
+    fragColor = color;
+}